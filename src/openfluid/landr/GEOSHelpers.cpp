@@ -62,6 +62,21 @@ GEOSGeom convertOGRGeometryToGEOS(const OGRGeometry* Geometry)
 // =====================================================================
 
 
+GEOSGeom convertOGRGeometryToGEOS(const OGRGeometry* Geometry, GEOSContextHandle_t ContextHandle)
+{
+#if GDAL_VERSION_MAJOR > 1 || (GDAL_VERSION_MAJOR == 1 && (GDAL_VERSION_MINOR > 11 || (GDAL_VERSION_MINOR == 11 )))
+  return Geometry->exportToGEOS(ContextHandle);
+#else
+  (void) ContextHandle;
+  return Geometry->exportToGEOS();
+#endif
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 OGRGeometry* convertGEOSGeometryToOGR(const GEOSGeom Geometry)
 {
 #if GDAL_VERSION_MAJOR > 1 || (GDAL_VERSION_MAJOR == 1 && (GDAL_VERSION_MINOR > 11 || (GDAL_VERSION_MINOR == 11 )))
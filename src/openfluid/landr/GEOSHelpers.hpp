@@ -78,6 +78,13 @@ namespace openfluid { namespace landr {
 GEOSGeom OPENFLUID_API convertOGRGeometryToGEOS(const OGRGeometry* Geometry);
 
 
+/**
+  @brief Converts an OGR geometry using an existing GEOS context, which allows
+  concurrent conversions when each thread owns its context.
+*/
+GEOSGeom OPENFLUID_API convertOGRGeometryToGEOS(const OGRGeometry* Geometry, GEOSContextHandle_t ContextHandle);
+
+
 OGRGeometry* /*OPENFLUID_API*/ convertGEOSGeometryToOGR(const GEOSGeom Geometry);
 
 
@@ -0,0 +1,158 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+
+*/
+
+
+
+/**
+  @file GeometriesView.cpp
+
+  @author Michael RABOTIN <michael.rabotin@supagro.inra.fr>
+*/
+
+
+#include <algorithm>
+
+#include <geos/geom/Geometry.h>
+#include <geos/geom/Envelope.h>
+#include <geos/geom/prep/PreparedGeometry.h>
+#include <geos/geom/prep/PreparedGeometryFactory.h>
+#include <geos/index/strtree/STRtree.h>
+
+#include <openfluid/landr/GeometriesView.hpp>
+
+
+namespace openfluid { namespace landr {
+
+
+GeometriesView::GeometriesView(const std::vector<const geos::geom::Geometry*>& Geometries) :
+    m_Geometries(Geometries), m_Ids(Geometries.size()), m_Prepared(Geometries.size())
+{
+  for (unsigned int i = 0; i < m_Ids.size(); i++)
+  {
+    m_Ids[i] = i;
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+GeometriesView::~GeometriesView()
+{
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void GeometriesView::buildIndex() const
+{
+  mp_Index.reset(new geos::index::strtree::STRtree());
+
+  for (unsigned int i = 0; i < m_Geometries.size(); i++)
+  {
+    // the envelopes are owned by the geometries
+    mp_Index->insert(m_Geometries[i]->getEnvelopeInternal(),
+                     const_cast<unsigned int*>(&m_Ids[i]));
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+const geos::geom::prep::PreparedGeometry* GeometriesView::prepared(unsigned int Index) const
+{
+  if (!m_Prepared[Index])
+  {
+    m_Prepared[Index].reset(geos::geom::prep::PreparedGeometryFactory::prepare(m_Geometries[Index]));
+  }
+
+  return m_Prepared[Index].get();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::vector<unsigned int> GeometriesView::queryEnvelope(const geos::geom::Geometry* Geom) const
+{
+  std::vector<unsigned int> Found;
+
+  if (m_Geometries.empty() || Geom->isEmpty())
+  {
+    return Found;
+  }
+
+  if (!mp_Index)
+  {
+    buildIndex();
+  }
+
+  std::vector<void*> Items;
+  mp_Index->query(Geom->getEnvelopeInternal(),Items);
+
+  for (void* Item : Items)
+  {
+    Found.push_back(*(static_cast<unsigned int*>(Item)));
+  }
+
+  std::sort(Found.begin(),Found.end());
+
+  return Found;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool GeometriesView::intersects(const geos::geom::Geometry* Geom) const
+{
+  std::vector<unsigned int> Candidates = queryEnvelope(Geom);
+
+  for (unsigned int i : Candidates)
+  {
+    if (prepared(i)->intersects(Geom))
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+} }  // namespaces
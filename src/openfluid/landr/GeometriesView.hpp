@@ -0,0 +1,130 @@
+/*
+
+  This file is part of OpenFLUID software
+  Copyright(c) 2007, INRA - Montpellier SupAgro
+
+
+ == GNU General Public License Usage ==
+
+  OpenFLUID is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OpenFLUID is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OpenFLUID. If not, see <http://www.gnu.org/licenses/>.
+
+
+ == Other Usage ==
+
+  Other Usage means a use of OpenFLUID that is inconsistent with the GPL
+  license, and requires a written agreement between You and INRA.
+  Licensees for Other Usage of OpenFLUID may use this file in accordance
+  with the terms contained in the written agreement between You and INRA.
+
+*/
+
+
+
+/**
+  @file GeometriesView.hpp
+
+  @author Michael RABOTIN <michael.rabotin@supagro.inra.fr>
+*/
+
+
+#ifndef __OPENFLUID_LANDR_GEOMETRIESVIEW_HPP__
+#define __OPENFLUID_LANDR_GEOMETRIESVIEW_HPP__
+
+
+#include <vector>
+#include <memory>
+
+#include <openfluid/dllexport.hpp>
+
+
+namespace geos {
+namespace geom {
+class Geometry;
+namespace prep {
+class PreparedGeometry;
+} }
+namespace index { namespace strtree {
+class STRtree;
+} } }
+
+
+namespace openfluid { namespace landr {
+
+
+/**
+  @brief A non-owning view on a set of geometries, with indexed access and spatial predicates.
+  @details The spatial index and the prepared geometries are built on first use only,
+  so that a view can be queried many times without materializing a geos::geom::GeometryCollection.
+  The viewed geometries must outlive the view. A view is not thread-safe.
+*/
+class OPENFLUID_API GeometriesView
+{
+  private:
+
+    std::vector<const geos::geom::Geometry*> m_Geometries;
+
+    std::vector<unsigned int> m_Ids;
+
+    mutable std::unique_ptr<geos::index::strtree::STRtree> mp_Index;
+
+    mutable std::vector<std::unique_ptr<geos::geom::prep::PreparedGeometry> > m_Prepared;
+
+    void buildIndex() const;
+
+    const geos::geom::prep::PreparedGeometry* prepared(unsigned int Index) const;
+
+
+  public:
+
+    GeometriesView(const std::vector<const geos::geom::Geometry*>& Geometries);
+
+    GeometriesView(const GeometriesView&) = delete;
+
+    GeometriesView& operator=(const GeometriesView&) = delete;
+
+    ~GeometriesView();
+
+    /**
+      @brief Returns the number of geometries of this view.
+    */
+    unsigned int size() const
+    {
+      return m_Geometries.size();
+    }
+
+    /**
+      @brief Returns the geometry at position Index of this view.
+    */
+    const geos::geom::Geometry* at(unsigned int Index) const
+    {
+      return m_Geometries.at(Index);
+    }
+
+    /**
+      @brief Returns the positions of the geometries whose envelope intersects the envelope of Geom, in view order.
+    */
+    std::vector<unsigned int> queryEnvelope(const geos::geom::Geometry* Geom) const;
+
+    /**
+      @brief Returns true if Geom intersects at least one geometry of this view.
+      @details Only the geometries selected by the spatial index are tested, using prepared geometries.
+    */
+    bool intersects(const geos::geom::Geometry* Geom) const;
+};
+
+
+} }  // namespaces
+
+
+#endif /* __OPENFLUID_LANDR_GEOMETRIESVIEW_HPP__ */
@@ -38,6 +38,8 @@
 
 
 #include <sstream>
+#include <vector>
+#include <cmath>
 
 #include <geos/planargraph/Node.h>
 #include <geos/geom/Polygon.h>
@@ -46,6 +48,7 @@
 #include <geos/geom/LineSegment.h>
 #include <geos/geom/GeometryFactory.h>
 #include <geos/operation/overlay/snap/GeometrySnapper.h>
+#include <geos/index/strtree/STRtree.h>
 
 #include <openfluid/landr/LandRGraph.hpp>
 #include <openfluid/landr/GEOSHelpers.hpp>
@@ -73,7 +76,8 @@ int LandRGraph::m_FileNum = 0;
 LandRGraph::LandRGraph() :
   geos::planargraph::PlanarGraph(),
   mp_Vector(nullptr), mp_Factory(geos::geom::GeometryFactory::getDefaultInstance()),
-  mp_Raster(nullptr), mp_RasterPolygonized(nullptr), mp_RasterPolygonizedPolys(nullptr)
+  mp_Raster(nullptr), mp_RasterPolygonized(nullptr), mp_RasterPolygonizedPolys(nullptr),
+  mp_RasterPolygonizedPolysIndex(nullptr)
 {
 }
 
@@ -85,7 +89,8 @@ LandRGraph::LandRGraph() :
 LandRGraph::LandRGraph(openfluid::core::GeoVectorValue& Val) :
   geos::planargraph::PlanarGraph(),
   mp_Factory(geos::geom::GeometryFactory::getDefaultInstance()),
-  mp_Raster(nullptr), mp_RasterPolygonized(nullptr), mp_RasterPolygonizedPolys(nullptr)
+  mp_Raster(nullptr), mp_RasterPolygonized(nullptr), mp_RasterPolygonizedPolys(nullptr),
+  mp_RasterPolygonizedPolysIndex(nullptr)
 {
   mp_Vector = new VectorDataset(Val);
 
@@ -125,10 +130,21 @@ LandRGraph::LandRGraph(openfluid::core::GeoVectorValue& Val) :
 
 
 LandRGraph::LandRGraph(const openfluid::landr::VectorDataset& Vect) :
+        LandRGraph(new openfluid::landr::VectorDataset(Vect))
+{
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+LandRGraph::LandRGraph(openfluid::landr::VectorDataset* Vect) :
         geos::planargraph::PlanarGraph(), mp_Factory(geos::geom::GeometryFactory::getDefaultInstance()),
-        mp_Raster(nullptr), mp_RasterPolygonized(nullptr), mp_RasterPolygonizedPolys(nullptr)
+        mp_Raster(nullptr), mp_RasterPolygonized(nullptr), mp_RasterPolygonizedPolys(nullptr),
+        mp_RasterPolygonizedPolysIndex(nullptr)
 {
-  mp_Vector = new openfluid::landr::VectorDataset(Vect);
+  mp_Vector = Vect;
 
   if (!mp_Vector)
   {
@@ -185,6 +201,7 @@ LandRGraph::~LandRGraph()
   }
 
   delete mp_RasterPolygonized;
+  delete mp_RasterPolygonizedPolysIndex;
 
   if (mp_RasterPolygonizedPolys)
   {
@@ -443,6 +460,9 @@ void LandRGraph::addAGeoRasterValue(openfluid::core::GeoRasterValue& Raster)
 
   mp_RasterPolygonized = nullptr;
   mp_RasterPolygonizedPolys = nullptr;
+
+  delete mp_RasterPolygonizedPolysIndex;
+  mp_RasterPolygonizedPolysIndex = nullptr;
 }
 
 
@@ -461,6 +481,9 @@ void LandRGraph::addAGeoRasterValue(const openfluid::landr::RasterDataset& Raste
 
   mp_RasterPolygonized = nullptr;
   mp_RasterPolygonizedPolys = nullptr;
+
+  delete mp_RasterPolygonizedPolysIndex;
+  mp_RasterPolygonizedPolysIndex = nullptr;
 }
 
 
@@ -492,6 +515,9 @@ openfluid::landr::VectorDataset* LandRGraph::rasterPolygonized()
 
     mp_RasterPolygonized = mp_Raster->polygonize(FileName.str());
     mp_RasterPolygonizedPolys = nullptr;
+
+    delete mp_RasterPolygonizedPolysIndex;
+    mp_RasterPolygonizedPolysIndex = nullptr;
   }
 
   return mp_RasterPolygonized;
@@ -554,6 +580,28 @@ std::vector<geos::geom::Polygon*>* LandRGraph::rasterPolygonizedPolys()
 // =====================================================================
 
 
+geos::index::strtree::STRtree* LandRGraph::rasterPolygonizedPolysIndex()
+{
+  if (!mp_RasterPolygonizedPolysIndex)
+  {
+    std::vector<geos::geom::Polygon*>* Polys = rasterPolygonizedPolys();
+
+    mp_RasterPolygonizedPolysIndex = new geos::index::strtree::STRtree();
+
+    for (geos::geom::Polygon* Poly : *Polys)
+    {
+      mp_RasterPolygonizedPolysIndex->insert(Poly->getEnvelopeInternal(),Poly);
+    }
+  }
+
+  return mp_RasterPolygonizedPolysIndex;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 double LandRGraph::getRasterValueForEntityCentroid(const LandREntity& Entity)
 {
 
@@ -572,26 +620,52 @@ double LandRGraph::getRasterValueForEntityCentroid(const LandREntity& Entity)
 // =====================================================================
 
 
-void LandRGraph::setAttributeFromRasterValueAtCentroid(const std::string& AttributeName)
+void LandRGraph::setAttributeFromRasterValueAtCentroid(const std::string& AttributeName,
+                                                       unsigned int RasterBandIndex)
 {
+  if (!mp_Raster)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"No raster associated to the LandRGraph");
+  }
+
   addAttribute(AttributeName);
 
+  // all the centroids are sampled in a single pass over the raster,
+  // the entities outside of the raster extent are left out without reading it
+  std::vector<geos::geom::Coordinate> Centroids;
+  std::vector<LandREntity*> Sampled;
+  Centroids.reserve(m_Entities.size());
+  Sampled.reserve(m_Entities.size());
+
   LandRGraph::Entities_t::iterator it = m_Entities.begin();
   LandRGraph::Entities_t::iterator ite = m_Entities.end();
   for (; it != ite; ++it)
   {
-    double* Val = new double (getRasterValueForEntityCentroid(*const_cast<LandREntity*>(*it)));
+    const geos::geom::Coordinate& Centroid = *(*it)->centroid()->getCoordinate();
 
-    if (!Val)
+    if (!mp_Raster->isInExtent(Centroid))
     {
-      std::ostringstream s;
-      s << "No raster value for entity " << (*it)->getOfldId() << " centroid.";
-
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, s.str());
+      if (mp_Raster->getOutOfExtentPolicy() == RasterDataset::OUT_OF_EXTENT_THROW)
+      {
+        throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+      }
+      continue;
     }
 
-    (*it)->setAttributeValue(AttributeName, new core::DoubleValue(*Val));
-    delete Val;
+    Centroids.push_back(Centroid);
+    Sampled.push_back(*it);
+  }
+
+  std::vector<float> Values(Centroids.size());
+  mp_Raster->getValuesOfCoordinates(Centroids.data(),Centroids.size(),Values.data(),RasterBandIndex);
+
+  // NaN values, as nodata pixels masked by the raster policy, give no attribute value
+  for (unsigned int i = 0; i < Sampled.size(); i++)
+  {
+    if (!std::isnan(Values[i]))
+    {
+      Sampled[i]->setAttributeValue(AttributeName, new core::DoubleValue((double)Values[i]));
+    }
   }
 }
 
@@ -55,7 +55,10 @@ class GeometryFactory;
 class LineString;
 class Polygon;
 class Coordinate;
-} }
+}
+namespace index { namespace strtree {
+class STRtree;
+} } }
 
 namespace planargraph {
 class Node;
@@ -128,6 +131,11 @@ class OPENFLUID_API LandRGraph: public geos::planargraph::PlanarGraph
     */
     std::vector<geos::geom::Polygon*>* mp_RasterPolygonizedPolys;
 
+    /**
+      @brief A spatial index of mp_RasterPolygonizedPolys, built on first use.
+    */
+    geos::index::strtree::STRtree* mp_RasterPolygonizedPolysIndex;
+
     static int m_FileNum;
 
     LandRGraph();
@@ -142,6 +150,12 @@ class OPENFLUID_API LandRGraph: public geos::planargraph::PlanarGraph
     */
     LandRGraph(const openfluid::landr::VectorDataset& Vect);
 
+    /**
+      @brief Creates a new LandRGraph from a VectorDataset, without copying it.
+      @param Vect The VectorDataset, owned by this LandRGraph.
+    */
+    LandRGraph(openfluid::landr::VectorDataset* Vect);
+
     /**
       @brief Adds LandREntity from the associated VectorDataset of this LandRGraph.
     */
@@ -265,6 +279,12 @@ class OPENFLUID_API LandRGraph: public geos::planargraph::PlanarGraph
     */
     std::vector<geos::geom::Polygon*>* rasterPolygonizedPolys();
 
+    /**
+      @brief Returns a spatial index of the polygons of rasterPolygonizedPolys(), built once per associated raster.
+      @details The items of the index are the geos::geom::Polygon of rasterPolygonizedPolys().
+    */
+    geos::index::strtree::STRtree* rasterPolygonizedPolysIndex();
+
     /**
       @brief Fetchs the associated raster value corresponding to the LandREntity centroid coordinate.
       @param Entity The LandREntity to get the centroid coordinate from.
@@ -275,9 +295,14 @@ class OPENFLUID_API LandRGraph: public geos::planargraph::PlanarGraph
     /**
       @brief Creates a new attribute for all the LandREntity of this LandRGraph, and set for each LandREntity
       this attribute value as the raster value corresponding to the LandREntity centroid coordinate.
+      @details The entities with a centroid outside of the raster extent are not sampled: they throw an exception
+      with the RasterDataset::OUT_OF_EXTENT_THROW policy of the raster, and get no value otherwise.
+      The entities with a NaN raster value get no value.
       @param AttributeName The name of the attribute to create.
+      @param RasterBandIndex The raster band index (default is 1).
+      @throw openfluid::base::FrameworkException if no raster is associated to this LandRGraph
     */
-    void setAttributeFromRasterValueAtCentroid(const std::string& AttributeName);
+    void setAttributeFromRasterValueAtCentroid(const std::string& AttributeName, unsigned int RasterBandIndex = 1);
 
     /**
       @brief Creates a new attribute for all the LandREntity of this LandRGraph, and set for each LandREntity
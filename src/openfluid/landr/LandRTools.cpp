@@ -38,6 +38,12 @@
 */
 
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 #include <geos/geom/Geometry.h>
 #include <geos/geom/LineString.h>
 #include <geos/geom/Polygon.h>
@@ -135,8 +141,8 @@ std::vector<geos::geom::LineString*> LandRTools::computeVectorOfExteriorRings(op
 
   std::vector<geos::geom::LineString*> Lines;
 
-  geos::geom::Geometry* Geom = Val.geometries();
-  unsigned int iEnd=Geom->getNumGeometries();
+  const GeometriesView& Geoms = Val.geometriesView();
+  unsigned int iEnd=Geoms.size();
 
   for (unsigned int i = 0; i < iEnd; i++)
   {
@@ -144,7 +150,7 @@ std::vector<geos::geom::LineString*> LandRTools::computeVectorOfExteriorRings(op
     Lines.push_back(
       const_cast<geos::geom::LineString*>(
         dynamic_cast<geos::geom::Polygon*>(
-          const_cast<geos::geom::Geometry*>(Geom->getGeometryN(i))
+          const_cast<geos::geom::Geometry*>(Geoms.at(i))
         )->getExteriorRing()
       )
     );
@@ -167,13 +173,13 @@ std::vector<geos::geom::LineString*> LandRTools::computeVectorOfLines(openfluid:
 
   std::vector<geos::geom::LineString*> Lines;
 
-  geos::geom::Geometry* Geom = Val.geometries();
+  const GeometriesView& Geoms = Val.geometriesView();
 
-  unsigned int iEnd=Geom->getNumGeometries();
+  unsigned int iEnd=Geoms.size();
   for (unsigned int i = 0; i < iEnd; i++)
   {
     Lines.push_back(
-      dynamic_cast<geos::geom::LineString*>(const_cast<geos::geom::Geometry*>(Geom->getGeometryN(i)))
+      dynamic_cast<geos::geom::LineString*>(const_cast<geos::geom::Geometry*>(Geoms.at(i)))
     );
   }
 
@@ -764,6 +770,75 @@ bool LandRTools::isExtentsIntersect(std::vector<OGREnvelope> vEnvelope)
   return true;
 }
 
+
+// =====================================================================
+// =====================================================================
+
+
+void LandRTools::runInParallel(unsigned int TasksCount,
+                               const std::function<void(unsigned int)>& Task,
+                               unsigned int ThreadsCount)
+{
+  if (!ThreadsCount)
+  {
+    ThreadsCount = std::max(1u,std::thread::hardware_concurrency());
+  }
+
+  ThreadsCount = std::min(ThreadsCount,TasksCount);
+
+  if (ThreadsCount <= 1)
+  {
+    for (unsigned int i = 0; i < TasksCount; i++)
+    {
+      Task(i);
+    }
+    return;
+  }
+
+  std::atomic<unsigned int> NextTask(0);
+  std::exception_ptr FirstError;
+  std::mutex ErrorMutex;
+
+  auto Worker = [&]()
+  {
+    unsigned int i;
+    while ((i = NextTask++) < TasksCount)
+    {
+      try
+      {
+        Task(i);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> Lock(ErrorMutex);
+        if (!FirstError)
+        {
+          FirstError = std::current_exception();
+        }
+        // remaining tasks are skipped
+        NextTask = TasksCount;
+      }
+    }
+  };
+
+  std::vector<std::thread> Workers;
+  for (unsigned int t = 0; t < ThreadsCount; t++)
+  {
+    Workers.push_back(std::thread(Worker));
+  }
+
+  for (unsigned int t = 0; t < ThreadsCount; t++)
+  {
+    Workers[t].join();
+  }
+
+  if (FirstError)
+  {
+    std::rethrow_exception(FirstError);
+  }
+}
+
+
 /*template<typename T>
 geos::geom::CoordinateArraySequence LandRTools::ArrayFromCoordinates(const *T GeomPtr) {
   return geos::geom::CoordinateArraySequence(*(GeomPtr->getCoordinates().release()));
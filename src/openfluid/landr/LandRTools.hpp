@@ -43,6 +43,7 @@
 
 #include <vector>
 #include <list>
+#include <functional>
 
 #include <geos/geom/CoordinateArraySequenceFactory.h>
 
@@ -222,6 +223,19 @@ class OPENFLUID_API LandRTools
     */
      static bool isExtentsIntersect(std::vector<OGREnvelope> vEnvelope);
 
+    /**
+      @brief Runs a task for each index in [0,TasksCount[ on a pool of worker threads.
+      @details Indexes are dispatched one by one to the first idle worker, so that unbalanced tasks
+      are spread over the threads. The first exception thrown by a task is rethrown
+      in the calling thread once all workers are joined.
+      @param TasksCount The number of tasks.
+      @param Task The function to run for each task index, must be safe to call concurrently.
+      @param ThreadsCount The number of worker threads, 0 (default) for the number of available cores.
+    */
+    static void runInParallel(unsigned int TasksCount,
+                              const std::function<void(unsigned int)>& Task,
+                              unsigned int ThreadsCount = 0);
+
     /*template<typename T>
     static geos::geom::CoordinateArraySequence ArrayFromCoordinates(const T& GeomPtr);*/
 
@@ -38,10 +38,14 @@
 
 
  #include <algorithm>
+ #include <cmath>
+ #include <limits>
  #include <sstream>
+ #include <vector>
 
  #include <geos/planargraph/DirectedEdge.h>
  #include <geos/planargraph/Node.h>
+ #include <geos/geom/Coordinate.h>
  #include <geos/geom/CoordinateSequence.h>
  #include <geos/geom/LineString.h>
  #include <geos/geom/GeometryFactory.h>
@@ -95,6 +99,16 @@ LineStringGraph::LineStringGraph(openfluid::landr::VectorDataset& Vect) : LandRG
 // =====================================================================
 
 
+LineStringGraph::LineStringGraph(openfluid::landr::VectorDataset* Vect) : LandRGraph(Vect)
+{
+
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 LineStringGraph::~LineStringGraph()
 {
 
@@ -139,6 +153,46 @@ LineStringGraph* LineStringGraph::create(openfluid::landr::VectorDataset& Vect)
 // =====================================================================
 
 
+LineStringGraph* LineStringGraph::create(openfluid::core::GeoVectorValue& Val, const OGREnvelope& Extent,
+                                         const std::string& AttributeFilter)
+{
+  if (!Val.isLineType())
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"GeoVectorValue is not Line type");
+  }
+
+  // the filtered copy is owned by the graph, it is not copied again
+  LineStringGraph* Graph = new LineStringGraph(new openfluid::landr::VectorDataset(Val,Extent,AttributeFilter));
+  Graph->addEntitiesFromGeoVector();
+
+  return Graph;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+LineStringGraph* LineStringGraph::create(openfluid::core::GeoVectorValue& Val, OGRGeometry* Clip,
+                                         const std::string& AttributeFilter)
+{
+  if (!Val.isLineType())
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"GeoVectorValue is not Line type");
+  }
+
+  // the filtered copy is owned by the graph, it is not copied again
+  LineStringGraph* Graph = new LineStringGraph(new openfluid::landr::VectorDataset(Val,Clip,AttributeFilter));
+  Graph->addEntitiesFromGeoVector();
+
+  return Graph;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 LineStringGraph* LineStringGraph::create(const LandRGraph::Entities_t& Entities)
 {
   LineStringGraph* Graph = new LineStringGraph();
@@ -345,27 +399,59 @@ double LineStringGraph::getRasterValueForEntityEndNode(LineStringEntity& Entity)
 // =====================================================================
 
 
-void LineStringGraph::setAttributeFromRasterValueAtStartNode(const std::string& AttributeName)
+std::vector<float> LineStringGraph::getRasterValuesForEntitiesNodes(bool WithStartNodes, bool WithEndNodes,
+                                                                    RasterDataset::InterpolationMethod Method)
 {
-  addAttribute(AttributeName);
+  if (!mp_Raster)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"No raster associated to the LineStringGraph");
+  }
+
+  std::vector<geos::geom::Coordinate> Coords;
+  Coords.reserve(m_Entities.size() * 2);
 
   LandRGraph::Entities_t::iterator it = m_Entities.begin();
   LandRGraph::Entities_t::iterator ite = m_Entities.end();
 
   for (; it != ite; ++it)
   {
-    float* Val = new float(getRasterValueForEntityStartNode(*dynamic_cast<LineStringEntity*>(*it)));
+    LineStringEntity* Entity = dynamic_cast<LineStringEntity*>(*it);
 
-    if (!Val)
+    if (WithStartNodes)
     {
-      std::ostringstream s;
-      s << "No raster value for entity " << (*it)->getOfldId() << " StartNode.";
-
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, s.str());
+      Coords.push_back(Entity->startNode()->getCoordinate());
+    }
+    if (WithEndNodes)
+    {
+      Coords.push_back(Entity->endNode()->getCoordinate());
     }
+  }
+
+  std::vector<float> Values(Coords.size());
+  mp_Raster->getInterpolatedValuesOfCoordinates(Coords.data(),Coords.size(),Values.data(),Method);
+
+  return Values;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void LineStringGraph::setAttributeFromRasterValueAtStartNode(const std::string& AttributeName,
+                                                             RasterDataset::InterpolationMethod Method)
+{
+  std::vector<float> Values = getRasterValuesForEntitiesNodes(true,false,Method);
+
+  addAttribute(AttributeName);
 
-    (*it)->setAttributeValue(AttributeName, new core::DoubleValue(*Val));
-    delete Val;
+  LandRGraph::Entities_t::iterator it = m_Entities.begin();
+  LandRGraph::Entities_t::iterator ite = m_Entities.end();
+  unsigned int i = 0;
+
+  for (; it != ite; ++it)
+  {
+    (*it)->setAttributeValue(AttributeName, new core::DoubleValue(Values[i++]));
   }
 }
 
@@ -397,27 +483,20 @@ void LineStringGraph::printCurrent()
 // =====================================================================
 
 
-void LineStringGraph::setAttributeFromRasterValueAtEndNode(const std::string& AttributeName)
+void LineStringGraph::setAttributeFromRasterValueAtEndNode(const std::string& AttributeName,
+                                                           RasterDataset::InterpolationMethod Method)
 {
+  std::vector<float> Values = getRasterValuesForEntitiesNodes(false,true,Method);
+
   addAttribute(AttributeName);
 
   LandRGraph::Entities_t::iterator it = m_Entities.begin();
   LandRGraph::Entities_t::iterator ite = m_Entities.end();
+  unsigned int i = 0;
 
   for (; it != ite; ++it)
   {
-    float* Val = new float (getRasterValueForEntityEndNode(*dynamic_cast<LineStringEntity*>(*it)));
-
-    if (!Val)
-    {
-      std::ostringstream s;
-      s << "No raster value for entity " << (*it)->getOfldId() << " EndNode.";
-
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, s.str());
-    }
-
-    (*it)->setAttributeValue(AttributeName, new core::DoubleValue(*Val));
-    delete Val;
+    (*it)->setAttributeValue(AttributeName, new core::DoubleValue(Values[i++]));
   }
 }
 
@@ -518,45 +597,252 @@ bool LineStringGraph::isLineStringGraphArborescence( )
 
 void LineStringGraph::setAttributeFromMeanRasterValues(const std::string& AttributeName)
 {
+  // start and end values of each entity, sampled in a single pass over the raster
+  std::vector<float> Values = getRasterValuesForEntitiesNodes(true,true);
+
   addAttribute(AttributeName);
 
   LandRGraph::Entities_t::iterator it = m_Entities.begin();
   LandRGraph::Entities_t::iterator ite = m_Entities.end();
+  unsigned int i = 0;
 
   for (; it != ite; ++it)
   {
-    float* EndVal = new float(getRasterValueForEntityEndNode(*dynamic_cast<LineStringEntity*>(*it)));
+    float Val = (Values[i]+Values[i+1]) / 2;
+    (*it)->setAttributeValue(AttributeName,new core::DoubleValue(Val));
+    i += 2;
+  }
+}
+
 
-    if (!EndVal)
+
+// =====================================================================
+// =====================================================================
+
+
+LineStringGraph::RasterProfile::RasterProfile() :
+    Mean(std::numeric_limits<double>::quiet_NaN()), Min(std::numeric_limits<double>::quiet_NaN()),
+    Max(std::numeric_limits<double>::quiet_NaN()), Slope(std::numeric_limits<double>::quiet_NaN()),
+    MaxSlope(std::numeric_limits<double>::quiet_NaN()), Count(0)
+{
+
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+double LineStringGraph::RasterProfile::get(Statistic Stat) const
+{
+  switch (Stat)
+  {
+    case MEAN:
+      return Mean;
+    case MIN:
+      return Min;
+    case MAX:
+      return Max;
+    case SLOPE:
+      return Slope;
+    case MAXSLOPE:
+      return MaxSlope;
+  }
+
+  return std::numeric_limits<double>::quiet_NaN();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::vector<LineStringGraph::RasterProfile> LineStringGraph::computeRasterProfiles(
+    RasterDataset::InterpolationMethod Method)
+{
+  if (!mp_Raster)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"No raster associated to the LineStringGraph");
+  }
+
+  const double Step = std::min(std::fabs(mp_Raster->getPixelWidth()),std::fabs(mp_Raster->getPixelHeight()));
+  const OGREnvelope Extent = mp_Raster->envelope();
+
+  // samples of all the entities, with their distance along their entity,
+  // the samples outside of the raster are kept as gaps in the profiles
+  std::vector<geos::geom::Coordinate> Samples;
+  std::vector<double> Distances;
+  std::vector<bool> InExtent;
+  std::vector<std::size_t> FirstSamples;
+
+  auto addSample = [&](const geos::geom::Coordinate& Coo, double Distance)
+  {
+    Samples.push_back(Coo);
+    Distances.push_back(Distance);
+    InExtent.push_back(Coo.x >= Extent.MinX && Coo.x < Extent.MaxX && Coo.y > Extent.MinY && Coo.y <= Extent.MaxY);
+  };
+
+  for (LandREntity* Entity : m_Entities)
+  {
+    FirstSamples.push_back(Samples.size());
+
+    const geos::geom::CoordinateSequence* Coords = dynamic_cast<LineStringEntity*>(Entity)->line()->getCoordinatesRO();
+    double Distance = 0;
+
+    if (Coords->isEmpty())
     {
-      std::ostringstream s;
-      s << "No raster value for entity " << (*it)->getOfldId() << " EndNode.";
+      continue;
+    }
+
+    addSample(Coords->getAt(0),0);
+
+    for (std::size_t i = 1; i < Coords->size(); i++)
+    {
+      const geos::geom::Coordinate& From = Coords->getAt(i-1);
+      const geos::geom::Coordinate& To = Coords->getAt(i);
+      const double Length = From.distance(To);
+
+      if (!Length)
+      {
+        continue;
+      }
+
+      // the segment is cut in equal parts no longer than a pixel
+      const unsigned int Parts = std::max(1u,unsigned(std::ceil(Length / Step)));
+
+      for (unsigned int p = 1; p <= Parts; p++)
+      {
+        const double Ratio = double(p) / Parts;
+        addSample(geos::geom::Coordinate(From.x + Ratio * (To.x - From.x),From.y + Ratio * (To.y - From.y)),
+                  Distance + Ratio * Length);
+      }
 
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, s.str());
+      Distance += Length;
     }
+  }
 
-    float* StartVal = new float( getRasterValueForEntityStartNode(*dynamic_cast<LineStringEntity*>(*it)));
+  FirstSamples.push_back(Samples.size());
 
-    if (!StartVal)
+  // all the samples of the graph inside the raster in a single pass over the raster
+  std::vector<geos::geom::Coordinate> InsideSamples;
+  for (std::size_t i = 0; i < Samples.size(); i++)
+  {
+    if (InExtent[i])
     {
-      std::ostringstream s;
-      s << "No raster value for entity " << (*it)->getOfldId() << " StartNode.";
+      InsideSamples.push_back(Samples[i]);
+    }
+  }
+
+  std::vector<float> InsideValues(InsideSamples.size());
+  mp_Raster->getInterpolatedValuesOfCoordinates(InsideSamples.data(),InsideSamples.size(),InsideValues.data(),Method);
+
+  int HasNoData = 0;
+  const float NoData = float(mp_Raster->rasterBand(1)->GetNoDataValue(&HasNoData));
 
-      if (EndVal)
+  // samples outside of the raster, NaN and nodata samples are all invalid
+  std::vector<float> Values(Samples.size(),std::numeric_limits<float>::quiet_NaN());
+  std::vector<bool> IsValid(Samples.size(),false);
+
+  for (std::size_t i = 0, j = 0; i < Samples.size(); i++)
+  {
+    if (InExtent[i])
+    {
+      Values[i] = InsideValues[j++];
+      IsValid[i] = !std::isnan(Values[i]) && !(HasNoData && Values[i] == NoData);
+    }
+  }
+
+  std::vector<RasterProfile> Profiles(m_Entities.size());
+
+  for (std::size_t e = 0; e < Profiles.size(); e++)
+  {
+    RasterProfile& Profile = Profiles[e];
+
+    const std::size_t First = FirstSamples[e];
+    const std::size_t End = FirstSamples[e+1];
+    std::size_t Previous = End;
+    std::size_t FirstValid = End;
+    double WeightedSum = 0;
+    double WeightsSum = 0;
+    double Sum = 0;
+
+    for (std::size_t i = First; i < End; i++)
+    {
+      if (!IsValid[i])
       {
-        delete EndVal;
+        continue;
       }
 
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, s.str());
+      if (!Profile.Count)
+      {
+        Profile.Min = Values[i];
+        Profile.Max = Values[i];
+        Profile.MaxSlope = 0;
+        FirstValid = i;
+      }
+      else
+      {
+        Profile.Min = std::min(Profile.Min,double(Values[i]));
+        Profile.Max = std::max(Profile.Max,double(Values[i]));
+      }
+
+      // each sample stands for the half lengths to its neighbour samples, when they are valid,
+      // so that gaps of invalid samples are not counted
+      const double Before = (i > First && IsValid[i-1] ? Distances[i] - Distances[i-1] : 0);
+      const double After = (i + 1 < End && IsValid[i+1] ? Distances[i+1] - Distances[i] : 0);
+      const double Weight = (Before + After) / 2;
+
+      WeightedSum += Weight * Values[i];
+      WeightsSum += Weight;
+      Sum += Values[i];
 
-      return;
+      if (Previous != End && Distances[i] > Distances[Previous])
+      {
+        Profile.MaxSlope = std::max(Profile.MaxSlope,
+                                    std::fabs(Values[i] - Values[Previous]) / (Distances[i] - Distances[Previous]));
+      }
+
+      Previous = i;
+      Profile.Count++;
     }
 
-    float Val = (*StartVal+*EndVal) / 2;
-    (*it)->setAttributeValue(AttributeName,new core::DoubleValue(Val));
+    if (!Profile.Count)
+    {
+      continue;
+    }
+
+    // isolated samples only: they all stand for the same length
+    Profile.Mean = (WeightsSum > 0 ? WeightedSum / WeightsSum : Sum / Profile.Count);
+
+    const double ProfileLength = Distances[Previous] - Distances[FirstValid];
+    Profile.Slope = (ProfileLength > 0 ? (Values[FirstValid] - Values[Previous]) / ProfileLength : 0);
+  }
+
+  return Profiles;
+}
+
+
+// =====================================================================
+// =====================================================================
+
 
-    delete EndVal;
-    delete StartVal;
+void LineStringGraph::setAttributeFromRasterProfile(const std::string& AttributeName, RasterProfile::Statistic Stat,
+                                                    RasterDataset::InterpolationMethod Method)
+{
+  std::vector<RasterProfile> Profiles = computeRasterProfiles(Method);
+
+  addAttribute(AttributeName);
+
+  LandRGraph::Entities_t::iterator it = m_Entities.begin();
+  LandRGraph::Entities_t::iterator ite = m_Entities.end();
+  unsigned int i = 0;
+
+  for (; it != ite; ++it, ++i)
+  {
+    if (Profiles[i].Count)
+    {
+      (*it)->setAttributeValue(AttributeName, new core::DoubleValue(Profiles[i].get(Stat)));
+    }
   }
 }
 
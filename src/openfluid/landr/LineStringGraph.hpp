@@ -41,8 +41,11 @@
 #define __OPENFLUID_LANDR_LINESTRINGGRAPH_HPP__
 
 
+#include <vector>
+
 #include <openfluid/landr/LandRGraph.hpp>
 #include <openfluid/landr/LineStringEntity.hpp>
+#include <openfluid/landr/RasterDataset.hpp>
 #include <openfluid/dllexport.hpp>
 
 
@@ -119,6 +122,46 @@ class VectorDataset;
 */
 class OPENFLUID_API LineStringGraph : public LandRGraph
 {
+  public:
+
+    /**
+      @brief Statistics of the raster values sampled along a LineStringEntity.
+      @details NaN and nodata samples are ignored. When no valid sample is found, Count is 0
+      and the other statistics are NaN.
+    */
+    struct RasterProfile
+    {
+      enum Statistic { MEAN, MIN, MAX, SLOPE, MAXSLOPE };
+
+      /**
+        @brief The mean of the samples, each sample being weighted by the length of line it stands for.
+        Only the lengths between consecutive valid samples are counted, gaps of invalid samples are left out.
+      */
+      double Mean;
+
+      double Min;
+
+      double Max;
+
+      /**
+        @brief The drop between the first and the last valid samples, divided by the length between them.
+        Positive when the values decrease from StartNode to EndNode.
+      */
+      double Slope;
+
+      /**
+        @brief The steepest absolute slope between two consecutive valid samples.
+      */
+      double MaxSlope;
+
+      unsigned int Count;
+
+      RasterProfile();
+
+      double get(Statistic Stat) const;
+    };
+
+
   private:
 
     LineStringGraph(LineStringGraph& Other);
@@ -138,6 +181,12 @@ class OPENFLUID_API LineStringGraph : public LandRGraph
     */
     LineStringGraph(openfluid::landr::VectorDataset& Vect);
 
+    /**
+    @brief Creates a new LineStringGraph from a VectorDataset, without copying it.
+    @param Vect The VectorDataset, owned by this LineStringGraph.
+    */
+    LineStringGraph(openfluid::landr::VectorDataset* Vect);
+
     /**
     @brief Adds a LandREntity into this LineStringGraph.
     */
@@ -151,6 +200,17 @@ class OPENFLUID_API LineStringGraph : public LandRGraph
     */
     virtual LandREntity* createNewEntity(const geos::geom::Geometry* Geom, unsigned int OfldId);
 
+    /**
+    @brief Samples the associated raster at the nodes of all the LineStringEntities in a single pass.
+    @param WithStartNodes True to sample the StartNode of each entity.
+    @param WithEndNodes True to sample the EndNode of each entity.
+    @param Method The interpolation method of the raster values (default is NEAREST).
+    @return The sampled values, in entities order, the StartNode value before the EndNode value of each entity.
+    */
+    std::vector<float> getRasterValuesForEntitiesNodes(bool WithStartNodes, bool WithEndNodes,
+                                                       RasterDataset::InterpolationMethod Method =
+                                                           RasterDataset::NEAREST);
+
 
   public:
 
@@ -170,6 +230,27 @@ class OPENFLUID_API LineStringGraph : public LandRGraph
     */
     static LineStringGraph* create(openfluid::landr::VectorDataset& Vect);
 
+    /**
+    @brief Creates a new LineStringGraph initialized from the features of a core::GeoVectorValue within an extent.
+    @details Only the features intersecting Extent and matching AttributeFilter are read.
+    @param Val The core::GeoVectorValue, composed of LineStrings each containing a "OFLD_ID" attribute.
+    @param Extent The extent of the features to load.
+    @param AttributeFilter An OGR SQL WHERE clause restricting the features to load, empty for none.
+    */
+    static LineStringGraph* create(openfluid::core::GeoVectorValue& Val, const OGREnvelope& Extent,
+                                   const std::string& AttributeFilter = "");
+
+    /**
+    @brief Creates a new LineStringGraph initialized from the features of a core::GeoVectorValue
+    intersecting a geometry.
+    @details Only the features intersecting Clip and matching AttributeFilter are read.
+    @param Val The core::GeoVectorValue, composed of LineStrings each containing a "OFLD_ID" attribute.
+    @param Clip The geometry the features to load must intersect.
+    @param AttributeFilter An OGR SQL WHERE clause restricting the features to load, empty for none.
+    */
+    static LineStringGraph* create(openfluid::core::GeoVectorValue& Val, OGRGeometry* Clip,
+                                   const std::string& AttributeFilter = "");
+
     /**
     @brief Creates a new LineStringGraph initialized with a list of LandREntity.
     @param Entities A list of LandREntity which must be LineStringEntity.
@@ -231,15 +312,21 @@ class OPENFLUID_API LineStringGraph : public LandRGraph
     @brief Creates a new attribute for these LineStringGraph entities, and set for each LineStringEntity
     this attribute value as the associated raster values corresponding to the StartNode LineStringEntity coordinates.
     @param AttributeName The name of the attribute to create for the StartNode
+    @param Method The interpolation method of the raster values (default is NEAREST, the value of the pixel
+    containing the StartNode)
     */
-    void setAttributeFromRasterValueAtStartNode(const std::string& AttributeName);
+    void setAttributeFromRasterValueAtStartNode(const std::string& AttributeName,
+                                                RasterDataset::InterpolationMethod Method = RasterDataset::NEAREST);
 
     /**
     @brief Creates a new attribute for these LineStringGraph entities, and set for each LineStringEntity
     this attribute value as the associated raster values corresponding to the EndNode LineStringEntity coordinates.
     @param AttributeName The name of the attribute to create for the EndNode
+    @param Method The interpolation method of the raster values (default is NEAREST, the value of the pixel
+    containing the EndNode)
     */
-    void setAttributeFromRasterValueAtEndNode(const std::string& AttributeName);
+    void setAttributeFromRasterValueAtEndNode(const std::string& AttributeName,
+                                              RasterDataset::InterpolationMethod Method = RasterDataset::NEAREST);
 
     /**
     @brief Reverse a LineStringEntity orientation.
@@ -260,6 +347,30 @@ class OPENFLUID_API LineStringGraph : public LandRGraph
     */
     virtual void setAttributeFromMeanRasterValues(const std::string& AttributeName);
 
+    /**
+    @brief Samples the associated raster along all the LineStringEntities, and computes their profile statistics.
+    @details Each entity is walked with a step of one pixel, vertices included. The samples of the whole graph
+    are then read in a single pass over the raster, sorted by raster tile.
+    Samples outside of the raster are invalid, like NaN and nodata samples.
+    @param Method The interpolation method of the raster values (default is NEAREST).
+    @return The profile of each entity, in entities order.
+    @throw openfluid::base::FrameworkException if no raster is associated to this LineStringGraph.
+    */
+    std::vector<RasterProfile> computeRasterProfiles(RasterDataset::InterpolationMethod Method =
+                                                         RasterDataset::NEAREST);
+
+    /**
+    @brief Creates a new attribute for this LineStringGraph entities, and set for each LineStringEntity
+    this attribute value as a statistic of the raster profile along the entity.
+    Entities without valid samples get no value.
+    @param AttributeName The name of the attribute to create.
+    @param Stat The statistic to use.
+    @param Method The interpolation method of the raster values (default is NEAREST).
+    @throw openfluid::base::FrameworkException if no raster is associated to this LineStringGraph.
+    */
+    void setAttributeFromRasterProfile(const std::string& AttributeName, RasterProfile::Statistic Stat,
+                                       RasterDataset::InterpolationMethod Method = RasterDataset::NEAREST);
+
     /**
     @brief Merges a LineStringEntity into an other one.
     @details The LineStringEntity to merge is deleted.
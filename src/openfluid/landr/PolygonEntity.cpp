@@ -666,7 +666,7 @@ std::multimap<double,PolygonEntity*> PolygonEntity::getOrderedNeighboursByLength
 // =====================================================================
 
 
-std::pair<LandREntity *, double> PolygonEntity::computeNeighbourByLineTopology(VectorDataset LineTopology)
+std::pair<LandREntity *, double> PolygonEntity::computeNeighbourByLineTopology(VectorDataset& LineTopology)
 {
   if (!LineTopology.isLineType())
   {
@@ -683,21 +683,24 @@ std::pair<LandREntity *, double> PolygonEntity::computeNeighbourByLineTopology(V
 
   std::pair<LandREntity*, double > pairNeighLength;
 
+  const GeometriesView& Lines = LineTopology.geometriesView();
+
   // no Intersection between this PolygonEntity and the lines of the VectorDataset
-  if (!(geometry()->intersects(LineTopology.geometries())))
+  if (!Lines.intersects(geometry()))
   {
     pairNeighLength = std::make_pair(Down,FlowLength);
     return pairNeighLength;
   }
 
-  geos::geom::Geometry* PtIntersect = (LineTopology.geometries());
+  // only the lines within the envelope of this PolygonEntity may start inside it
+  std::vector<unsigned int> Candidates = Lines.queryEnvelope(geometry());
   geos::geom::LineString* Line = nullptr;
   bool cover = false;
   unsigned int i = 0;
 
-  while (i<PtIntersect->getNumGeometries()&&!cover)
+  while (i<Candidates.size()&&!cover)
   {
-    const geos::geom::Geometry* GeomL = PtIntersect->getGeometryN(i);
+    const geos::geom::Geometry* GeomL = Lines.at(Candidates[i]);
     Line = dynamic_cast<geos::geom::LineString*>(const_cast<geos::geom::Geometry*>(GeomL));
     std::unique_ptr<geos::geom::Point> Point = Line->getStartPoint();
 
@@ -277,7 +277,7 @@ class OPENFLUID_API PolygonEntity: public LandREntity
       @return A pair of openfluid::landr:landREntity and the length of the line of the VectorDataset
       or an empty pair if not found.
     */
-   std::pair< LandREntity*, double> computeNeighbourByLineTopology(VectorDataset LineTopology);
+   std::pair< LandREntity*, double> computeNeighbourByLineTopology(VectorDataset& LineTopology);
 
 };
 
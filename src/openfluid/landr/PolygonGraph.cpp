@@ -38,7 +38,9 @@
 
 
  #include <algorithm>
+ #include <cmath>
  #include <complex>
+ #include <memory>
 
  #include <geos/geom/Polygon.h>
  #include <geos/geom/Point.h>
@@ -46,6 +48,9 @@
  #include <geos/geom/MultiLineString.h>
  #include <geos/geom/GeometryFactory.h>
  #include <geos/geom/Geometry.h>
+ #include <geos/geom/prep/PreparedGeometry.h>
+ #include <geos/geom/prep/PreparedGeometryFactory.h>
+ #include <geos/index/strtree/STRtree.h>
  #include <geos/operation/valid/RepeatedPointRemover.h>
  #include <geos/planargraph/DirectedEdge.h>
 
@@ -96,6 +101,16 @@ PolygonGraph::PolygonGraph(openfluid::landr::VectorDataset& Vect) : LandRGraph(V
 // =====================================================================
 
 
+PolygonGraph::PolygonGraph(openfluid::landr::VectorDataset* Vect) : LandRGraph(Vect)
+{
+
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 PolygonGraph* PolygonGraph::create(openfluid::core::GeoVectorValue& Val)
 {
   if (!Val.isPolygonType())
@@ -148,6 +163,64 @@ PolygonGraph* PolygonGraph::create(openfluid::landr::VectorDataset& Vect)
 // =====================================================================
 
 
+PolygonGraph* PolygonGraph::create(openfluid::core::GeoVectorValue& Val, const OGREnvelope& Extent,
+                                   const std::string& AttributeFilter)
+{
+  if (!Val.isPolygonType())
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"GeoVectorValue is not Polygon type");
+  }
+
+  // the filtered copy is owned by the graph, it is not copied again
+  PolygonGraph* Graph = new PolygonGraph(new openfluid::landr::VectorDataset(Val,Extent,AttributeFilter));
+
+  try
+  {
+    Graph->addEntitiesFromGeoVector();
+  }
+  catch (openfluid::base::FrameworkException& e)
+  {
+    delete Graph;
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Unable to create the PolygonGraph");
+  }
+
+  return Graph;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+PolygonGraph* PolygonGraph::create(openfluid::core::GeoVectorValue& Val, OGRGeometry* Clip,
+                                   const std::string& AttributeFilter)
+{
+  if (!Val.isPolygonType())
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"GeoVectorValue is not Polygon type");
+  }
+
+  // the filtered copy is owned by the graph, it is not copied again
+  PolygonGraph* Graph = new PolygonGraph(new openfluid::landr::VectorDataset(Val,Clip,AttributeFilter));
+
+  try
+  {
+    Graph->addEntitiesFromGeoVector();
+  }
+  catch (openfluid::base::FrameworkException& e)
+  {
+    delete Graph;
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Unable to create the PolygonGraph");
+  }
+
+  return Graph;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 PolygonGraph* PolygonGraph::create(const LandRGraph::Entities_t& Entities)
 {
   PolygonGraph* Graph = new PolygonGraph();
@@ -494,13 +567,33 @@ PolygonGraph::RastValByRastPoly_t PolygonGraph::computeRasterPolyOverlapping(Pol
                                               "No RasterPolygonizedMultiPolygon associated to the PolygonGraph");
   }
 
-  std::vector<geos::geom::Polygon*>::iterator it = RasterPolys->begin();
-  std::vector<geos::geom::Polygon*>::iterator ite = RasterPolys->end();
-  for (; it != ite; ++it)
+  std::vector<void*> Candidates;
+  rasterPolygonizedPolysIndex()->query(RefPoly->getEnvelopeInternal(),Candidates);
+
+  if (Candidates.empty())
+  {
+    return IntersectPolys;
+  }
+
+  std::unique_ptr<geos::geom::prep::PreparedGeometry> PreparedRef(
+      geos::geom::prep::PreparedGeometryFactory::prepare(RefPoly));
+
+  for (void* Candidate : Candidates)
   {
-    if (RefPoly->relate(*it, "21*******"))
+    geos::geom::Polygon* RastPoly = static_cast<geos::geom::Polygon*>(Candidate);
+
+    // raster polygon fully inside the entity, the intersection is the raster polygon itself
+    if (PreparedRef->containsProperly(RastPoly))
+    {
+      geos::geom::Polygon* Poly = dynamic_cast<geos::geom::Polygon*>(RastPoly->clone().release());
+
+      // !! copy doesn't keep UserData !
+      Poly->setUserData(RastPoly->getUserData());
+      IntersectPolys[Poly] = Poly->getArea();
+    }
+    else if (PreparedRef->intersects(RastPoly) && RefPoly->relate(RastPoly, "21*******"))
     {
-      geos::geom::Geometry* Inter = RefPoly->intersection(*it).release();
+      geos::geom::Geometry* Inter = RefPoly->intersection(RastPoly).release();
       unsigned int iEnd=Inter->getNumGeometries();
 
       for (unsigned int i = 0; i < iEnd; i++)
@@ -511,7 +604,7 @@ PolygonGraph::RastValByRastPoly_t PolygonGraph::computeRasterPolyOverlapping(Pol
         if (Poly)
         {
           // !! copy doesn't keep UserData !
-          Poly->setUserData((*it)->getUserData());
+          Poly->setUserData(RastPoly->getUserData());
           IntersectPolys[Poly] = Poly->getArea();
         }
       }
@@ -526,46 +619,209 @@ PolygonGraph::RastValByRastPoly_t PolygonGraph::computeRasterPolyOverlapping(Pol
 // =====================================================================
 
 
-void PolygonGraph::setAttributeFromMeanRasterValues(const std::string& AttributeName)
+void PolygonGraph::runOnEntitiesWithRaster(
+    const std::function<void(LandREntity&, const geos::geom::Polygon&, RasterDataset&)>& Task,
+    unsigned int ThreadsCount)
 {
-  addAttribute(AttributeName);
+  if (!mp_Raster)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"No raster associated to the PolygonGraph");
+  }
 
-  LandRGraph::Entities_t::iterator it = m_Entities.begin();
-  LandRGraph::Entities_t::iterator ite = m_Entities.end();
+  // entities are ordered by the raster block under their envelope center, so that a group reads close lines
+  int BlockXSize, BlockYSize;
+  mp_Raster->rasterBand(1)->GetBlockSize(&BlockXSize,&BlockYSize);
 
-  for (; it != ite; ++it)
+  geos::geom::Coordinate* Origin = mp_Raster->computeOrigin();
+  const double BlockWidth = BlockXSize * mp_Raster->getPixelWidth();
+  const double BlockHeight = BlockYSize * mp_Raster->getPixelHeight();
+
+  std::vector<std::pair<std::pair<long, long>, LandREntity*>> Located;
+
+  for (LandREntity* Entity : m_Entities)
+  {
+    geos::geom::Coordinate Center;
+    dynamic_cast<PolygonEntity*>(Entity)->polygon()->getEnvelopeInternal()->centre(Center);
+
+    Located.push_back(std::make_pair(std::make_pair(long(std::floor((Center.y - Origin->y) / BlockHeight)),
+                                                    long(std::floor((Center.x - Origin->x) / BlockWidth))),
+                                     Entity));
+  }
+
+  delete Origin;
+
+  std::stable_sort(Located.begin(),Located.end(),
+                   [](const std::pair<std::pair<long, long>, LandREntity*>& A,
+                      const std::pair<std::pair<long, long>, LandREntity*>& B)
   {
-    PolygonGraph::RastValByRastPoly_t RastPolys = computeRasterPolyOverlapping(
-        *dynamic_cast<PolygonEntity*>(*it));
+    return A.first < B.first;
+  });
 
-    double PolyArea = (double)(*it)->getArea();
+  const unsigned int GroupSize = 16;
+  const unsigned int GroupsCount = (Located.size() + GroupSize - 1) / GroupSize;
 
-    if (!PolyArea)
+  mp_Raster->runOnCopies(GroupsCount,[&](unsigned int Group, RasterDataset& Raster)
+  {
+    for (std::size_t i = Group * GroupSize; i < std::min(Located.size(),std::size_t(Group + 1) * GroupSize); i++)
     {
-      continue;
+      LandREntity* Entity = Located[i].second;
+
+      // a private clone, as GEOS geometries lazily cache their envelopes
+      std::unique_ptr<geos::geom::Geometry> Zone = dynamic_cast<PolygonEntity*>(Entity)->polygon()->clone();
+
+      Task(*Entity,*dynamic_cast<geos::geom::Polygon*>(Zone.get()),Raster);
     }
+  },ThreadsCount);
+}
+
+
+// =====================================================================
+// =====================================================================
 
-    double Mean = 0;
 
-    PolygonGraph::RastValByRastPoly_t::iterator itPix = RastPolys.begin();
-    PolygonGraph::RastValByRastPoly_t::iterator itPixE = RastPolys.end();
+void PolygonGraph::setAttributeFromMeanRasterValues(const std::string& AttributeName)
+{
+  setAttributeFromMeanRasterValues(AttributeName,1);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void PolygonGraph::setAttributeFromMeanRasterValues(const std::string& AttributeName, unsigned int ThreadsCount)
+{
+  if (!mp_Raster)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"No raster associated to the PolygonGraph");
+  }
+
+  addAttribute(AttributeName);
+
+  // each entity is written by a single task, no lock is needed
+  runOnEntitiesWithRaster([&](LandREntity& Entity, const geos::geom::Polygon& Zone, RasterDataset& Raster)
+  {
+    // NaN and nodata pixels are left out, entities outside of the raster extent are not read
+    RasterDataset::ZonalStatistics Stats = Raster.computeZonalStatistics(&Zone);
 
-    for (; itPix != itPixE; ++itPix)
+    if (!Stats.Count)
     {
-      double* PixelVal = ((double*) itPix->first->getUserData());
+      return;
+    }
 
-      if (std::isnan(*PixelVal))
-      {
-        *PixelVal = 1;
-      }
+    Entity.setAttributeValue(AttributeName, new core::DoubleValue(Stats.Mean));
+  },ThreadsCount);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void PolygonGraph::prepareRasterOverviews(double Accuracy)
+{
+  if (Accuracy <= 0)
+  {
+    return;
+  }
+
+  double MaxArea = 0;
+
+  for (LandREntity* Entity : m_Entities)
+  {
+    MaxArea = std::max(MaxArea,dynamic_cast<PolygonEntity*>(Entity)->polygon()->getArea());
+  }
+
+  // without overviews, e.g. when the raster directory is read-only, the statistics are computed at full resolution
+  try
+  {
+    mp_Raster->selectOverviewLevel(MaxArea,Accuracy);
+  }
+  catch (openfluid::base::FrameworkException&)
+  {
+
+  }
+}
 
-      double OverlappingArea = (double)itPix->second;
 
-      Mean += *PixelVal * (OverlappingArea / PolyArea);
+// =====================================================================
+// =====================================================================
+
+
+void PolygonGraph::setAttributeFromRasterStatistics(const std::string& AttributeName,
+                                                    RasterDataset::ZonalStatistics::Statistic Stat,
+                                                    bool ExactCoverage,
+                                                    unsigned int ThreadsCount,
+                                                    double Accuracy)
+{
+  if (!mp_Raster)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"No raster associated to the PolygonGraph");
+  }
+
+  addAttribute(AttributeName);
+
+  prepareRasterOverviews(Accuracy);
+
+  runOnEntitiesWithRaster([&](LandREntity& Entity, const geos::geom::Polygon& Zone, RasterDataset& Raster)
+  {
+    RasterDataset::ZonalStatistics Stats =
+        Raster.overview(Raster.selectOverviewLevel(Zone.getArea(), Accuracy, false))
+          .computeZonalStatistics(&Zone, ExactCoverage);
+
+    if (!Stats.Count)
+    {
+      return;
     }
 
-    (*it)->setAttributeValue(AttributeName, new core::DoubleValue(Mean));
+    Entity.setAttributeValue(AttributeName, new core::DoubleValue(Stats.get(Stat)));
+  },ThreadsCount);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void PolygonGraph::setAttributeFromRasterStatistics(const std::vector<std::string>& AttributeNames,
+                                                    RasterDataset::ZonalStatistics::Statistic Stat,
+                                                    const std::vector<unsigned int>& RasterBandIndexes,
+                                                    bool ExactCoverage,
+                                                    unsigned int ThreadsCount,
+                                                    double Accuracy)
+{
+  if (!mp_Raster)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"No raster associated to the PolygonGraph");
   }
+
+  if (AttributeNames.size() != RasterBandIndexes.size())
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Attribute names and raster band indexes do not match");
+  }
+
+  for (const std::string& AttributeName : AttributeNames)
+  {
+    addAttribute(AttributeName);
+  }
+
+  prepareRasterOverviews(Accuracy);
+
+  runOnEntitiesWithRaster([&](LandREntity& Entity, const geos::geom::Polygon& Zone, RasterDataset& Raster)
+  {
+    std::vector<RasterDataset::ZonalStatistics> Stats =
+        Raster.overview(Raster.selectOverviewLevel(Zone.getArea(), Accuracy, false))
+          .computeZonalStatistics(&Zone, RasterBandIndexes, ExactCoverage);
+
+    for (std::size_t i = 0; i < Stats.size(); i++)
+    {
+      if (Stats[i].Count)
+      {
+        Entity.setAttributeValue(AttributeNames[i], new core::DoubleValue(Stats[i].get(Stat)));
+      }
+    }
+  },ThreadsCount);
 }
 
 
@@ -41,10 +41,13 @@
 #define __OPENFLUID_LANDR_POLYGONGRAPH_HPP__
 
 
+#include <functional>
+
 #include <openfluid/core/Value.hpp>
 #include <openfluid/core/DoubleValue.hpp>
 #include <openfluid/landr/LandRGraph.hpp>
 #include <openfluid/landr/PolygonEntity.hpp>
+#include <openfluid/landr/RasterDataset.hpp>
 #include <openfluid/dllexport.hpp>
 
 
@@ -72,6 +75,24 @@ class OPENFLUID_API PolygonGraph: public LandRGraph
     */
     PolygonGraph(PolygonGraph& Other);
 
+    /**
+      @brief Runs a task on each PolygonEntity with the associated raster, on a pool of worker threads.
+      @details Entities are grouped by the raster block under their envelope center,
+      and each worker uses a private copy of the raster. The task receives a private clone of the entity polygon
+      and must only modify the given entity.
+      @throw openfluid::base::FrameworkException if no raster is associated to this PolygonGraph
+    */
+    void runOnEntitiesWithRaster(
+        const std::function<void(LandREntity&, const geos::geom::Polygon&, RasterDataset&)>& Task,
+        unsigned int ThreadsCount = 0);
+
+    /**
+      @brief Builds the overviews of the associated raster if the largest PolygonEntity needs them
+      for the requested accuracy, before the workers copy the raster.
+      If they can not be built, the entities are read at full resolution.
+    */
+    void prepareRasterOverviews(double Accuracy);
+
 
   protected:
 
@@ -87,6 +108,12 @@ class OPENFLUID_API PolygonGraph: public LandRGraph
     */
     PolygonGraph(openfluid::landr::VectorDataset& Vect);
 
+    /**
+      @brief Creates a new PolygonGraph from a VectorDataset, without copying it.
+      @param Vect The VectorDataset, owned by this PolygonGraph.
+    */
+    PolygonGraph(openfluid::landr::VectorDataset* Vect);
+
     /**
       @brief Adds a LandREntity into this PolygonGraph.
     */
@@ -148,6 +175,26 @@ class OPENFLUID_API PolygonGraph: public LandRGraph
     */
     static PolygonGraph* create(openfluid::landr::VectorDataset& Vect);
 
+    /**
+      @brief Create a new PolygonGraph initialized from the features of a core::GeoVectorValue within an extent.
+      @details Only the features intersecting Extent and matching AttributeFilter are read.
+      @param Val The core::GeoVectorValue, composed of Polygons each containing a "OFLD_ID" attribute.
+      @param Extent The extent of the features to load.
+      @param AttributeFilter An OGR SQL WHERE clause restricting the features to load, empty for none.
+    */
+    static PolygonGraph* create(openfluid::core::GeoVectorValue& Val, const OGREnvelope& Extent,
+                                const std::string& AttributeFilter = "");
+
+    /**
+      @brief Create a new PolygonGraph initialized from the features of a core::GeoVectorValue intersecting a geometry.
+      @details Only the features intersecting Clip and matching AttributeFilter are read.
+      @param Val The core::GeoVectorValue, composed of Polygons each containing a "OFLD_ID" attribute.
+      @param Clip The geometry the features to load must intersect.
+      @param AttributeFilter An OGR SQL WHERE clause restricting the features to load, empty for none.
+    */
+    static PolygonGraph* create(openfluid::core::GeoVectorValue& Val, OGRGeometry* Clip,
+                                const std::string& AttributeFilter = "");
+
     /**
       @brief Create a new PolygonGraph initialized with a list of LandREntity.
       @details Entities must be PolygonEntity.
@@ -180,6 +227,8 @@ class OPENFLUID_API PolygonGraph: public LandRGraph
 
     /**
       @brief Gets a map of polygonized Raster polygons and its area intersecting Entity.
+      @details Only the polygons found in rasterPolygonizedPolysIndex() are tested against the prepared Entity,
+      and the polygons fully inside Entity are taken as they are, without computing an intersection.
       @param Entity The PolygonEntity to compare with the associated Raster.
       @return A map of polygonized Raster Polygons, from associated polygonized raster,
       with for each one the intersection area.
@@ -189,10 +238,72 @@ class OPENFLUID_API PolygonGraph: public LandRGraph
     /**
       @brief Creates a new attribute for this PolygonGraph entities, and set for each PolygonEntity
       this attribute value as the mean of the overlapping raster values, relative to overlapping areas.
+      @details The entities are scanned over the raster grid with exact pixel coverage,
+      the raster is not polygonized. Entities are processed one after the other.
+      NaN and nodata pixels are left out of the mean, entities covering no valid pixel get no value.
       @param AttributeName The name of the attribute to create
     */
     virtual void setAttributeFromMeanRasterValues(const std::string& AttributeName);
 
+    /**
+      @brief Creates a new attribute for this PolygonGraph entities, and set for each PolygonEntity
+      this attribute value as the mean of the overlapping raster values, relative to overlapping areas.
+      @details Same as setAttributeFromMeanRasterValues(const std::string&),
+      with the entities processed on a pool of worker threads.
+      @param AttributeName The name of the attribute to create
+      @param ThreadsCount The number of worker threads, 0 for the number of available cores
+    */
+    void setAttributeFromMeanRasterValues(const std::string& AttributeName, unsigned int ThreadsCount);
+
+    /**
+      @brief Creates a new attribute for this PolygonGraph entities, and set for each PolygonEntity
+      this attribute value as a statistic of the raster values covered by the entity.
+      @details NaN and nodata pixels are ignored, entities covering no valid pixel get no value.
+      @param AttributeName The name of the attribute to create
+      @param Stat The statistic to compute
+      @param ExactCoverage If true, the pixels crossed by the entity boundary are weighted by
+      their covered fraction, otherwise only the pixels with center inside the entity are used (default is true)
+      @param ThreadsCount The number of worker threads, 0 (default) for the number of available cores
+      @param Accuracy If not 0, each entity is read at the coarsest raster overview level still accurate enough
+      for its area (see RasterDataset::selectOverviewLevel()) (default is 0). The missing overviews are built
+      with AVERAGE resampling and written aside the raster file (.ovr file); if this fails, e.g. in a read-only
+      directory, the full resolution is used. Averaged pixels smooth the values, so that MIN and MAX are biased
+      towards the mean and STDDEV is underestimated, while MEAN is preserved
+      @throw openfluid::base::FrameworkException if no raster is associated to this PolygonGraph
+    */
+    void setAttributeFromRasterStatistics(const std::string& AttributeName,
+                                          RasterDataset::ZonalStatistics::Statistic Stat,
+                                          bool ExactCoverage = true,
+                                          unsigned int ThreadsCount = 0,
+                                          double Accuracy = 0);
+
+    /**
+      @brief Creates new attributes for this PolygonGraph entities, and set for each PolygonEntity
+      these attributes values as a statistic of the values of several raster bands covered by the entity.
+      @details All the bands are computed in a single pass over each entity,
+      the values of the bands at a pixel being read together.
+      NaN and nodata pixels are ignored band by band, entities covering no valid pixel of a band get no value.
+      @param AttributeNames The names of the attributes to create, one per band
+      @param Stat The statistic to compute
+      @param RasterBandIndexes The raster band indexes, in the order of AttributeNames
+      @param ExactCoverage If true, the pixels crossed by the entity boundary are weighted by
+      their covered fraction, otherwise only the pixels with center inside the entity are used (default is true)
+      @param ThreadsCount The number of worker threads, 0 (default) for the number of available cores
+      @param Accuracy If not 0, each entity is read at the coarsest raster overview level still accurate enough
+      for its area (see RasterDataset::selectOverviewLevel()) (default is 0). The missing overviews are built
+      with AVERAGE resampling and written aside the raster file (.ovr file); if this fails, e.g. in a read-only
+      directory, the full resolution is used. Averaged pixels smooth the values, so that MIN and MAX are biased
+      towards the mean and STDDEV is underestimated, while MEAN is preserved
+      @throw openfluid::base::FrameworkException if no raster is associated to this PolygonGraph,
+      or if AttributeNames and RasterBandIndexes have different sizes
+    */
+    void setAttributeFromRasterStatistics(const std::vector<std::string>& AttributeNames,
+                                          RasterDataset::ZonalStatistics::Statistic Stat,
+                                          const std::vector<unsigned int>& RasterBandIndexes,
+                                          bool ExactCoverage = true,
+                                          unsigned int ThreadsCount = 0,
+                                          double Accuracy = 0);
+
     /**
       @brief Creates on disk a shapefile representing the PolygonEdges of this PolygonGraph.
       @param FilePath The path where to create the out file.
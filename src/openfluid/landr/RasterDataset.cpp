@@ -39,14 +39,37 @@
 
 
 #include <string>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <iomanip>
+#include <iterator>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include <tuple>
 
 #include <gdal_alg.h>
+#include <cpl_conv.h>
+#include <cpl_multiproc.h>
+#include <cpl_vsi.h>
 
 #include <geos/geom/Coordinate.h>
+#include <geos/geom/CoordinateSequence.h>
+#include <geos/geom/Envelope.h>
+#include <geos/geom/LineString.h>
+#include <geos/geom/Polygon.h>
+#include <geos/operation/intersection/Rectangle.h>
+#include <geos/operation/intersection/RectangleIntersection.h>
 
 #include <openfluid/core/GeoRasterValue.hpp>
 #include <openfluid/base/FrameworkException.hpp>
 #include <openfluid/landr/VectorDataset.hpp>
+#include <openfluid/landr/LandRTools.hpp>
 #include <openfluid/landr/RasterDataset.hpp>
 
 
@@ -54,7 +77,9 @@ namespace openfluid { namespace landr {
 
 
 RasterDataset::RasterDataset(openfluid::core::GeoRasterValue& Value) :
-    mp_GeoTransform(0)
+    mp_GeoTransform(0), m_CacheMemoryBudget(64*1024*1024), m_CacheMemoryUsage(0), m_TileXSize(0), m_TileYSize(0),
+    m_SourcePath(Value.getAbsolutePath()), m_MemoryMappingEnabled(true), m_OverviewsXSizesLoaded(false),
+    m_OutOfExtentAsNaN(false), m_NoDataAsNaN(false)
 {
   GDALAllRegister();
 
@@ -79,7 +104,13 @@ RasterDataset::RasterDataset(openfluid::core::GeoRasterValue& Value) :
 
 
 RasterDataset::RasterDataset(const RasterDataset& Other) :
-    mp_GeoTransform(0)
+    mp_GeoTransform(0), m_CacheMemoryBudget(Other.m_CacheMemoryBudget), m_CacheMemoryUsage(0),
+    m_TileXSize(0), m_TileYSize(0), m_InMemoryBands(Other.m_InMemoryBands),
+    m_SourcePath(Other.m_SourcePath), m_MemoryMappingEnabled(Other.m_MemoryMappingEnabled),
+    m_MappedBands(Other.m_MappedBands), m_ContentHashes(Other.m_ContentHashes),
+    m_OverviewsXSizes(Other.m_OverviewsXSizes), m_OverviewsXSizesLoaded(Other.m_OverviewsXSizesLoaded),
+    m_OutOfExtentAsNaN(Other.m_OutOfExtentAsNaN), m_NoDataAsNaN(Other.m_NoDataAsNaN),
+    m_NoDataValues(Other.m_NoDataValues)
 {
   GDALAllRegister();
 
@@ -103,6 +134,19 @@ RasterDataset::RasterDataset(const RasterDataset& Other) :
 // =====================================================================
 
 
+RasterDataset::RasterDataset(GDALDataset* Dataset) :
+    mp_Dataset(Dataset), mp_GeoTransform(0), m_CacheMemoryBudget(64*1024*1024), m_CacheMemoryUsage(0),
+    m_TileXSize(0), m_TileYSize(0), m_MemoryMappingEnabled(false), m_OverviewsXSizesLoaded(true),
+    m_OutOfExtentAsNaN(false), m_NoDataAsNaN(false)
+{
+
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 RasterDataset::~RasterDataset()
 {
   GDALClose(mp_Dataset);
@@ -146,8 +190,14 @@ GDALRasterBand* RasterDataset::rasterBand(unsigned int RasterBandIndex)
 
 std::pair<int, int> RasterDataset::getPixelFromCoordinate(geos::geom::Coordinate Coo)
 {
-  int offsetX = int((Coo.x - computeOrigin()->x) / getPixelWidth());
-  int offsetY = int((Coo.y - computeOrigin()->y) / getPixelHeight());
+  if (!mp_GeoTransform)
+  {
+    computeGeoTransform();
+  }
+
+  // rounded down, so that coordinates less than one pixel before the origin are outside of the raster
+  int offsetX = int(std::floor((Coo.x - mp_GeoTransform[0]) / mp_GeoTransform[1]));
+  int offsetY = int(std::floor((Coo.y - mp_GeoTransform[3]) / mp_GeoTransform[5]));
 
   return std::make_pair(offsetX, offsetY);
 }
@@ -174,12 +224,163 @@ geos::geom::Coordinate* RasterDataset::computeOrigin()
 
 void RasterDataset::computeGeoTransform()
 {
-  mp_GeoTransform = new double[6];
+  double GeoTransform[6];
 
-  if (GDALGetGeoTransform(mp_Dataset, mp_GeoTransform) != CE_None)
+  // the geotransform is kept only if it exists, so that a raster without georeferencing fails on every call
+  if (GDALGetGeoTransform(mp_Dataset, GeoTransform) != CE_None)
   {
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting GeoTransform information");
   }
+
+  mp_GeoTransform = new double[6];
+  std::copy(GeoTransform,GeoTransform+6,mp_GeoTransform);
+
+  const double X[2] = {mp_GeoTransform[0], mp_GeoTransform[0] + mp_Dataset->GetRasterXSize() * mp_GeoTransform[1]};
+  const double Y[2] = {mp_GeoTransform[3], mp_GeoTransform[3] + mp_Dataset->GetRasterYSize() * mp_GeoTransform[5]};
+
+  m_Envelope.MinX = std::min(X[0],X[1]);
+  m_Envelope.MaxX = std::max(X[0],X[1]);
+  m_Envelope.MinY = std::min(Y[0],Y[1]);
+  m_Envelope.MaxY = std::max(Y[0],Y[1]);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::setOutOfExtentPolicy(OutOfExtentPolicy Policy)
+{
+  m_OutOfExtentAsNaN = (Policy == OUT_OF_EXTENT_NAN);
+
+  // the overviews already opened follow the policy of their raster
+  for (auto& Overview : m_Overviews)
+  {
+    Overview.second->setOutOfExtentPolicy(Policy);
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+RasterDataset::OutOfExtentPolicy RasterDataset::getOutOfExtentPolicy() const
+{
+  return (m_OutOfExtentAsNaN ? OUT_OF_EXTENT_NAN : OUT_OF_EXTENT_THROW);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::setNoDataPolicy(NoDataPolicy Policy)
+{
+  if ((Policy == NODATA_NAN) != m_NoDataAsNaN)
+  {
+    // cached tiles are masked when read
+    clearCache();
+  }
+
+  m_NoDataAsNaN = (Policy == NODATA_NAN);
+
+  for (auto& Overview : m_Overviews)
+  {
+    Overview.second->setNoDataPolicy(Policy);
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+RasterDataset::NoDataPolicy RasterDataset::getNoDataPolicy() const
+{
+  return (m_NoDataAsNaN ? NODATA_NAN : NODATA_KEEP);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool RasterDataset::isInExtent(const geos::geom::Coordinate& Coo)
+{
+  if (!mp_GeoTransform)
+  {
+    computeGeoTransform();
+  }
+
+  // same rounding as getPixelFromCoordinate
+  const int Col = int(std::floor((Coo.x - mp_GeoTransform[0]) / mp_GeoTransform[1]));
+  const int Line = int(std::floor((Coo.y - mp_GeoTransform[3]) / mp_GeoTransform[5]));
+
+  return (Col >= 0 && Line >= 0 && Col < mp_Dataset->GetRasterXSize() && Line < mp_Dataset->GetRasterYSize());
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool RasterDataset::intersectsExtent(const geos::geom::Envelope& Env)
+{
+  if (!mp_GeoTransform)
+  {
+    computeGeoTransform();
+  }
+
+  return !Env.isNull() &&
+         Env.getMinX() <= m_Envelope.MaxX && Env.getMaxX() >= m_Envelope.MinX &&
+         Env.getMinY() <= m_Envelope.MaxY && Env.getMaxY() >= m_Envelope.MinY;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool RasterDataset::getNoDataValue(unsigned int RasterBandIndex, float& NoData)
+{
+  std::map<unsigned int, std::pair<int, float>>::iterator it = m_NoDataValues.find(RasterBandIndex);
+
+  if (it == m_NoDataValues.end())
+  {
+    int HasNoData = 0;
+    GDALRasterBand* Band = rasterBand(RasterBandIndex);
+    const float Value = Band ? float(Band->GetNoDataValue(&HasNoData)) : 0;
+
+    it = m_NoDataValues.insert(std::make_pair(RasterBandIndex,std::make_pair(Band ? HasNoData : 0,Value))).first;
+  }
+
+  NoData = it->second.second;
+
+  return it->second.first;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::maskNoData(unsigned int RasterBandIndex, float* Values, std::size_t Count)
+{
+  float NoData;
+
+  if (!m_NoDataAsNaN || !getNoDataValue(RasterBandIndex,NoData))
+  {
+    return;
+  }
+
+  for (std::size_t i = 0; i < Count; i++)
+  {
+    if (Values[i] == NoData)
+    {
+      Values[i] = std::numeric_limits<float>::quiet_NaN();
+    }
+  }
 }
 
 
@@ -219,22 +420,23 @@ double RasterDataset::getPixelHeight()
 
 std::vector<float> RasterDataset::getValuesOfLine(int LineIndex, unsigned int RasterBandIndex)
 {
-  std::vector<float> Val;
+  std::vector<float> Val(rasterBand(RasterBandIndex)->GetXSize());
 
-  int ColumnCount = rasterBand(RasterBandIndex)->GetXSize();
+  getValuesOfLine(LineIndex, Val.data(), RasterBandIndex);
 
-  float* ScanLine = (float *) CPLMalloc(sizeof(float) * ColumnCount);
+  return Val;
+}
 
-  rasterBand(RasterBandIndex)->RasterIO(GF_Read, 0, LineIndex, ColumnCount,
-                                           1, ScanLine, ColumnCount, 1,
-                                           GDT_Float32, 0, 0);
 
-  for (int i = 0; i < ColumnCount; i++)
-  {
-    Val.push_back(ScanLine[i]);
-  }
+// =====================================================================
+// =====================================================================
+
 
-  CPLFree(ScanLine);
+std::vector<float> RasterDataset::getValuesOfColumn(int ColIndex, unsigned int RasterBandIndex)
+{
+  std::vector<float> Val(rasterBand(RasterBandIndex)->GetYSize());
+
+  getValuesOfColumn(ColIndex, Val.data(), RasterBandIndex);
 
   return Val;
 }
@@ -244,26 +446,95 @@ std::vector<float> RasterDataset::getValuesOfLine(int LineIndex, unsigned int Ra
 // =====================================================================
 
 
-std::vector<float> RasterDataset::getValuesOfColumn(int ColIndex, unsigned int RasterBandIndex)
+void RasterDataset::getValuesOfLine(int LineIndex, float* Values, unsigned int RasterBandIndex)
 {
-  std::vector<float> Val;
+  if (readRasterWindow(RasterBandIndex, 0, LineIndex, mp_Dataset->GetRasterXSize(), 1, Values) != CE_None)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+  }
+}
 
-  int LineCount = rasterBand(RasterBandIndex)->GetYSize();
 
-  float* ScanLine = (float *) CPLMalloc(sizeof(float) * LineCount);
+// =====================================================================
+// =====================================================================
 
-  rasterBand(RasterBandIndex)->RasterIO(GF_Read, ColIndex, 0, 1, LineCount,
-                                           ScanLine, 1, LineCount, GDT_Float32,
-                                           0, 0);
 
-  for (int i = 0; i < LineCount; i++)
+void RasterDataset::getValuesOfColumn(int ColIndex, float* Values, unsigned int RasterBandIndex)
+{
+  const int XSize = mp_Dataset->GetRasterXSize();
+  const int YSize = mp_Dataset->GetRasterYSize();
+
+  if (ColIndex < 0 || ColIndex >= XSize || !rasterBand(RasterBandIndex))
   {
-    Val.push_back(ScanLine[i]);
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
   }
 
-  CPLFree(ScanLine);
+  DirectPixels Pixels;
 
-  return Val;
+  if (getDirectPixels(RasterBandIndex, Pixels))
+  {
+    for (int Line = 0; Line < YSize; Line++)
+    {
+      GDALCopyWords(const_cast<unsigned char*>(Pixels.Data) + Line * Pixels.LineSpace +
+                    GIntBig(ColIndex) * Pixels.PixelSpace,
+                    Pixels.DataType, 0, Values + Line, GDT_Float32, 0, 1);
+    }
+
+    return;
+  }
+
+  if (m_ColumnStrip.Values.empty() || m_ColumnStrip.RasterBandIndex != RasterBandIndex ||
+      ColIndex < m_ColumnStrip.FirstCol || ColIndex >= m_ColumnStrip.FirstCol + m_ColumnStrip.Width)
+  {
+    int BlockXSize, BlockYSize;
+    rasterBand(RasterBandIndex)->GetBlockSize(&BlockXSize,&BlockYSize);
+
+    // the strip covers the block columns of ColIndex, or if over the memory budget the narrower strip
+    // containing ColIndex among those splitting the block, so that sweeps in both directions reuse it
+    int FirstCol = (ColIndex / BlockXSize) * BlockXSize;
+    int Width = std::min(BlockXSize,XSize - FirstCol);
+    int MaxWidth = int(std::max(std::size_t(1),m_CacheMemoryBudget / (std::size_t(YSize) * sizeof(float))));
+
+    if (Width > MaxWidth)
+    {
+      FirstCol += ((ColIndex - FirstCol) / MaxWidth) * MaxWidth;
+      Width = std::min(MaxWidth,XSize - FirstCol);
+    }
+
+    releaseColumnStrip();
+    m_ColumnStrip.Values.resize(std::size_t(Width) * YSize);
+    m_CacheMemoryUsage += m_ColumnStrip.Values.size() * sizeof(float);
+    evictCacheTiles(0);
+
+    // read line-wise by chunks of block lines, then transposed
+    const int ChunkLines = std::max(1,std::min(YSize,BlockYSize));
+    std::vector<float> Chunk(std::size_t(Width) * ChunkLines);
+
+    for (int FirstLine = 0; FirstLine < YSize; FirstLine += ChunkLines)
+    {
+      int Lines = std::min(ChunkLines,YSize - FirstLine);
+
+      if (readRasterWindow(RasterBandIndex, FirstCol, FirstLine, Width, Lines, Chunk.data()) != CE_None)
+      {
+        releaseColumnStrip();
+        throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+      }
+
+      for (int l = 0; l < Lines; l++)
+      {
+        for (int c = 0; c < Width; c++)
+        {
+          m_ColumnStrip.Values[std::size_t(c) * YSize + FirstLine + l] = Chunk[std::size_t(l) * Width + c];
+        }
+      }
+    }
+
+    m_ColumnStrip.RasterBandIndex = RasterBandIndex;
+    m_ColumnStrip.FirstCol = FirstCol;
+    m_ColumnStrip.Width = Width;
+  }
+
+  std::copy_n(m_ColumnStrip.Values.begin() + std::size_t(ColIndex - m_ColumnStrip.FirstCol) * YSize,YSize,Values);
 }
 
 
@@ -271,27 +542,57 @@ std::vector<float> RasterDataset::getValuesOfColumn(int ColIndex, unsigned int R
 // =====================================================================
 
 
-float RasterDataset::getValueOfPixel(int ColIndex,
-                                     int LineIndex,
-                                     unsigned int RasterBandIndex)
+void RasterDataset::computeTileSize()
 {
-  float Val;
+  int BlockXSize, BlockYSize;
+  rasterBand(1)->GetBlockSize(&BlockXSize,&BlockYSize);
 
-  float* ScanLine = (float *) CPLMalloc(sizeof(float));
+  // small or strip-shaped blocks are grouped so that a tile covers at least 64x64 pixels
+  m_TileXSize = BlockXSize * std::max(1,(64 + BlockXSize - 1) / BlockXSize);
+  m_TileYSize = BlockYSize * std::max(1,(64 + BlockYSize - 1) / BlockYSize);
 
-  //  The pixel values will automatically be translated from the GDALRasterBand data type as needed.
-  if (rasterBand(RasterBandIndex)->RasterIO(GF_Read, ColIndex, LineIndex, 1,
-                                               1, ScanLine, 1, 1, GDT_Float32,
-                                               0, 0) != CE_None)
+  m_TileXSize = std::min(m_TileXSize,mp_Dataset->GetRasterXSize());
+  m_TileYSize = std::min(m_TileYSize,mp_Dataset->GetRasterYSize());
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+CPLErr RasterDataset::readRasterWindow(unsigned int RasterBandIndex, int XOffset, int YOffset, int XSize, int YSize,
+                                       float* Buffer)
+{
+  DirectPixels Pixels;
+
+  if (getDirectPixels(RasterBandIndex, Pixels))
   {
-    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+    if (XOffset < 0 || YOffset < 0 || XSize < 0 || YSize < 0 ||
+        XOffset + XSize > mp_Dataset->GetRasterXSize() || YOffset + YSize > mp_Dataset->GetRasterYSize())
+    {
+      return CE_Failure;
+    }
+
+    for (int Line = 0; Line < YSize; Line++)
+    {
+      GDALCopyWords(const_cast<unsigned char*>(Pixels.Data) + (YOffset + Line) * Pixels.LineSpace +
+                    GIntBig(XOffset) * Pixels.PixelSpace,
+                    Pixels.DataType, Pixels.PixelSpace, Buffer + std::size_t(Line) * XSize, GDT_Float32, sizeof(float),
+                    XSize);
+    }
+
+    return CE_None;
   }
 
-  Val = ScanLine[0];
+  GDALRasterBand* Band = rasterBand(RasterBandIndex);
 
-  CPLFree(ScanLine);
+  if (!Band)
+  {
+    return CE_Failure;
+  }
 
-  return Val;
+  //  The pixel values will automatically be translated from the GDALRasterBand data type as needed.
+  return Band->RasterIO(GF_Read, XOffset, YOffset, XSize, YSize, Buffer, XSize, YSize, GDT_Float32, 0, 0);
 }
 
 
@@ -299,12 +600,57 @@ float RasterDataset::getValueOfPixel(int ColIndex,
 // =====================================================================
 
 
-float RasterDataset::getValueOfCoordinate(geos::geom::Coordinate Coo,
-                                          unsigned int RasterBandIndex)
+CPLErr RasterDataset::readRasterWindow(const std::vector<unsigned int>& RasterBandIndexes,
+                                       int XOffset, int YOffset, int XSize, int YSize, float* Buffer)
 {
-  std::pair<int, int> Pixel = getPixelFromCoordinate(Coo);
+  const int BandsCount = int(RasterBandIndexes.size());
 
-  return getValueOfPixel(Pixel.first, Pixel.second, RasterBandIndex);
+  if (BandsCount == 1)
+  {
+    return readRasterWindow(RasterBandIndexes.front(), XOffset, YOffset, XSize, YSize, Buffer);
+  }
+
+  if (XOffset < 0 || YOffset < 0 || XSize < 0 || YSize < 0 ||
+      XOffset + XSize > mp_Dataset->GetRasterXSize() || YOffset + YSize > mp_Dataset->GetRasterYSize())
+  {
+    return CE_Failure;
+  }
+
+  std::vector<DirectPixels> Pixels(BandsCount);
+  bool AllDirect = true;
+
+  for (int b = 0; b < BandsCount && AllDirect; b++)
+  {
+    AllDirect = getDirectPixels(RasterBandIndexes[b], Pixels[b]);
+  }
+
+  if (AllDirect)
+  {
+    for (int b = 0; b < BandsCount; b++)
+    {
+      for (int Line = 0; Line < YSize; Line++)
+      {
+        GDALCopyWords(const_cast<unsigned char*>(Pixels[b].Data) + (YOffset + Line) * Pixels[b].LineSpace +
+                      GIntBig(XOffset) * Pixels[b].PixelSpace,
+                      Pixels[b].DataType, Pixels[b].PixelSpace,
+                      Buffer + std::size_t(Line) * XSize * BandsCount + b, GDT_Float32, BandsCount * sizeof(float),
+                      XSize);
+      }
+    }
+
+    return CE_None;
+  }
+
+  // a single pixel-interleaved read of all the bands
+  std::vector<int> BandMap(RasterBandIndexes.begin(),RasterBandIndexes.end());
+
+  return mp_Dataset->RasterIO(GF_Read, XOffset, YOffset, XSize, YSize, Buffer, XSize, YSize, GDT_Float32,
+                              BandsCount, BandMap.data(),
+                              BandsCount * sizeof(float), GIntBig(XSize) * BandsCount * sizeof(float), sizeof(float)
+#if (GDAL_VERSION_MAJOR >= 2)
+                              , nullptr
+#endif
+                              );
 }
 
 
@@ -312,35 +658,70 @@ float RasterDataset::getValueOfCoordinate(geos::geom::Coordinate Coo,
 // =====================================================================
 
 
-openfluid::landr::VectorDataset* RasterDataset::polygonize(const std::string& FileName,
-                                                           std::string FieldName,
-                                                           unsigned int RasterBandIndex)
+const RasterDataset::CacheTile& RasterDataset::getTile(unsigned int RasterBandIndex, int TileX, int TileY)
 {
-  if (!mp_PolygonizedByRasterBandIndex.count(RasterBandIndex))
+  std::uint64_t Key = (std::uint64_t(RasterBandIndex) << 48) | (std::uint64_t(TileY) << 24) | std::uint64_t(TileX);
+
+  auto Found = m_TilesCache.find(Key);
+
+  if (Found != m_TilesCache.end())
   {
-    FieldName = (FieldName == "" ? getDefaultPolygonizedFieldName() : FieldName);
+    m_TilesLRU.splice(m_TilesLRU.begin(),m_TilesLRU,Found->second.LRUPosition);
+    return Found->second;
+  }
 
-    mp_PolygonizedByRasterBandIndex.insert(
-        std::make_pair(RasterBandIndex,
-                       new openfluid::landr::VectorDataset(FileName)));
+  CacheTile Tile;
+  int XOffset = TileX * m_TileXSize;
+  int YOffset = TileY * m_TileYSize;
+  Tile.XSize = std::min(m_TileXSize,mp_Dataset->GetRasterXSize() - XOffset);
+  Tile.YSize = std::min(m_TileYSize,mp_Dataset->GetRasterYSize() - YOffset);
+  Tile.Values.resize(std::size_t(Tile.XSize) * Tile.YSize);
 
-    mp_PolygonizedByRasterBandIndex.at(RasterBandIndex)->addALayer("",wkbPolygon);
-    mp_PolygonizedByRasterBandIndex.at(RasterBandIndex)->addAField(FieldName,OFTReal);
+  if (readRasterWindow(RasterBandIndex, XOffset, YOffset, Tile.XSize, Tile.YSize, Tile.Values.data()) != CE_None)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+  }
 
-    int FieldIndex = mp_PolygonizedByRasterBandIndex.at(RasterBandIndex)->getFieldIndex(FieldName);
+  // the nodata mask is applied once per tile, not at each sampling
+  maskNoData(RasterBandIndex, Tile.Values.data(), Tile.Values.size());
 
-    OGRLayer* Layer = mp_PolygonizedByRasterBandIndex.at(RasterBandIndex)->layer(0);
+  m_TilesLRU.push_front(Key);
+  Tile.LRUPosition = m_TilesLRU.begin();
+  m_CacheMemoryUsage += Tile.Values.size() * sizeof(float);
 
-    if (GDALFPolygonize(rasterBand(RasterBandIndex), nullptr, Layer, FieldIndex,nullptr, nullptr, nullptr) != CE_None)
-    {
-      delete mp_PolygonizedByRasterBandIndex.at(RasterBandIndex);
-      mp_PolygonizedByRasterBandIndex.erase(RasterBandIndex);
+  CacheTile& Inserted = (m_TilesCache[Key] = std::move(Tile));
 
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Error while polygonizing raster.");
-    }
+  // least recently used tiles are evicted, the new tile is always kept
+  evictCacheTiles(1);
+
+  return Inserted;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::evictCacheTiles(std::size_t KeptTilesCount)
+{
+  while (m_CacheMemoryUsage > m_CacheMemoryBudget && m_TilesLRU.size() > KeptTilesCount)
+  {
+    auto Evicted = m_TilesCache.find(m_TilesLRU.back());
+    m_CacheMemoryUsage -= Evicted->second.Values.size() * sizeof(float);
+    m_TilesCache.erase(Evicted);
+    m_TilesLRU.pop_back();
   }
+}
 
-  return mp_PolygonizedByRasterBandIndex.at(RasterBandIndex);
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::releaseColumnStrip()
+{
+  m_CacheMemoryUsage -= m_ColumnStrip.Values.size() * sizeof(float);
+  std::vector<float>().swap(m_ColumnStrip.Values);
 }
 
 
@@ -348,9 +729,16 @@ openfluid::landr::VectorDataset* RasterDataset::polygonize(const std::string& Fi
 // =====================================================================
 
 
-std::string RasterDataset::getDefaultPolygonizedFieldName()
+void RasterDataset::setCacheMemoryBudget(std::size_t Bytes)
 {
-  return "PixelVal";
+  m_CacheMemoryBudget = Bytes;
+
+  evictCacheTiles(0);
+
+  if (m_CacheMemoryUsage > m_CacheMemoryBudget)
+  {
+    releaseColumnStrip();
+  }
 }
 
 
@@ -358,20 +746,2156 @@ std::string RasterDataset::getDefaultPolygonizedFieldName()
 // =====================================================================
 
 
-OGREnvelope RasterDataset::envelope()
+void RasterDataset::clearCache()
+{
+  m_TilesCache.clear();
+  m_TilesLRU.clear();
+  m_CacheMemoryUsage = 0;
+
+  std::vector<float>().swap(m_ColumnStrip.Values);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::loadInMemory(unsigned int RasterBandIndex, BufferType Type)
 {
-  OGREnvelope Envelope;
-  double adfGeoTransform[6];
-  if (source()->GetGeoTransform(adfGeoTransform) == CE_None)
+  GDALRasterBand* Band = rasterBand(RasterBandIndex);
+
+  if (!Band)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while loading raster band in memory.");
+  }
+
+  std::shared_ptr<InMemoryBand> Loaded = std::make_shared<InMemoryBand>();
+  Loaded->DataType = (Type == FLOAT64 ? GDT_Float64 : (Type == INT16 ? GDT_Int16 : GDT_Float32));
+  Loaded->XSize = mp_Dataset->GetRasterXSize();
+  Loaded->YSize = mp_Dataset->GetRasterYSize();
+  Loaded->Data.resize(std::size_t(Loaded->XSize) * Loaded->YSize * (GDALGetDataTypeSize(Loaded->DataType) / 8));
+
+  if (Band->RasterIO(GF_Read, 0, 0, Loaded->XSize, Loaded->YSize, Loaded->Data.data(),
+                     Loaded->XSize, Loaded->YSize, Loaded->DataType, 0, 0) != CE_None)
   {
-    Envelope.MinX = adfGeoTransform[0];
-    Envelope.MaxY = adfGeoTransform[3];
-    // Extent computation
-    Envelope.MaxX = adfGeoTransform[0] + (source()->GetRasterXSize() * adfGeoTransform[1]);
-    Envelope.MinY = adfGeoTransform[3] + (source()->GetRasterYSize() * adfGeoTransform[5]);
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while loading raster band in memory.");
+  }
+
+  m_InMemoryBands[RasterBandIndex] = Loaded;
+
+  // cached tiles of the band are useless from now on
+  clearCache();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::unloadFromMemory(unsigned int RasterBandIndex)
+{
+  m_InMemoryBands.erase(RasterBandIndex);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool RasterDataset::isLoadedInMemory(unsigned int RasterBandIndex) const
+{
+  return m_InMemoryBands.count(RasterBandIndex);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+const void* RasterDataset::inMemoryData(unsigned int RasterBandIndex, GDALDataType DataType) const
+{
+  auto InMemory = m_InMemoryBands.find(RasterBandIndex);
+
+  if (InMemory == m_InMemoryBands.end() || InMemory->second->DataType != DataType)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Raster band is not loaded in memory with the requested pixel type");
+  }
+
+  return InMemory->second->Data.data();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+RasterDataset::MappedBand::~MappedBand()
+{
+  CPLVirtualMemFree(Mem);
+  GDALClose(Dataset);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::shared_ptr<const RasterDataset::MappedBand> RasterDataset::mapBand(unsigned int RasterBandIndex)
+{
+#if (GDAL_VERSION_MAJOR >= 2)
+  if (m_SourcePath.empty() || !CPLIsVirtualMemFileMapAvailable() || !rasterBand(RasterBandIndex))
+  {
+    return nullptr;
+  }
+
+  GDALDatasetH Source = GDALOpen(m_SourcePath.c_str(), GA_ReadOnly);
+
+  if (!Source)
+  {
+    CPLErrorReset();
+    return nullptr;
+  }
+
+  if (GDALGetRasterXSize(Source) != mp_Dataset->GetRasterXSize() ||
+      GDALGetRasterYSize(Source) != mp_Dataset->GetRasterYSize() ||
+      GDALGetRasterCount(Source) < int(RasterBandIndex))
+  {
+    GDALClose(Source);
+    return nullptr;
+  }
+
+  GDALRasterBandH Band = GDALGetRasterBand(Source, RasterBandIndex);
+  int PixelSpace;
+  GIntBig LineSpace;
+
+  // only raw formats are mapped, GDAL must not emulate the mapping of the others
+  char** Options = CSLSetNameValue(nullptr, "USE_DEFAULT_IMPLEMENTATION", "NO");
+  CPLVirtualMem* Mem = GDALGetVirtualMemAuto(Band, GF_Read, &PixelSpace, &LineSpace, Options);
+  CSLDestroy(Options);
+
+  if (!Mem)
+  {
+    CPLErrorReset();
+    GDALClose(Source);
+    return nullptr;
+  }
+
+  std::shared_ptr<MappedBand> Mapped = std::make_shared<MappedBand>();
+  Mapped->Dataset = Source;
+  Mapped->Mem = Mem;
+  Mapped->Pixels.Data = static_cast<const unsigned char*>(CPLVirtualMemGetAddr(Mem));
+  Mapped->Pixels.DataType = GDALGetRasterDataType(Band);
+  Mapped->Pixels.PixelSpace = PixelSpace;
+  Mapped->Pixels.LineSpace = LineSpace;
+
+  return Mapped;
+#else
+  (void)RasterBandIndex;
+  return nullptr;
+#endif
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool RasterDataset::getDirectPixels(unsigned int RasterBandIndex, DirectPixels& Pixels)
+{
+  auto InMemory = m_InMemoryBands.find(RasterBandIndex);
+
+  if (InMemory != m_InMemoryBands.end())
+  {
+    const InMemoryBand& Band = *InMemory->second;
+    Pixels.Data = Band.Data.data();
+    Pixels.DataType = Band.DataType;
+    Pixels.PixelSpace = GDALGetDataTypeSize(Band.DataType) / 8;
+    Pixels.LineSpace = GIntBig(Band.XSize) * Pixels.PixelSpace;
+    return true;
+  }
+
+  if (!m_MemoryMappingEnabled)
+  {
+    return false;
+  }
+
+  auto Mapped = m_MappedBands.find(RasterBandIndex);
+
+  if (Mapped == m_MappedBands.end())
+  {
+    Mapped = m_MappedBands.insert(std::make_pair(RasterBandIndex, mapBand(RasterBandIndex))).first;
+  }
+
+  if (!Mapped->second)
+  {
+    return false;
+  }
+
+  Pixels = Mapped->second->Pixels;
+  return true;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::setMemoryMappingEnabled(bool Enabled)
+{
+  m_MemoryMappingEnabled = Enabled;
+
+  if (!Enabled)
+  {
+    m_MappedBands.clear();
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool RasterDataset::isMemoryMapped(unsigned int RasterBandIndex)
+{
+  DirectPixels Pixels;
+
+  return !m_InMemoryBands.count(RasterBandIndex) && getDirectPixels(RasterBandIndex, Pixels);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+float RasterDataset::getValueOfPixel(int ColIndex,
+                                     int LineIndex,
+                                     unsigned int RasterBandIndex)
+{
+  if (!rasterBand(RasterBandIndex))
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+  }
+
+  if (ColIndex < 0 || LineIndex < 0 ||
+      ColIndex >= mp_Dataset->GetRasterXSize() || LineIndex >= mp_Dataset->GetRasterYSize())
+  {
+    if (m_OutOfExtentAsNaN)
+    {
+      return std::numeric_limits<float>::quiet_NaN();
+    }
+
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+  }
+
+  DirectPixels Pixels;
+
+  if (getDirectPixels(RasterBandIndex, Pixels))
+  {
+    float Value;
+    readRasterWindow(RasterBandIndex, ColIndex, LineIndex, 1, 1, &Value);
+    maskNoData(RasterBandIndex, &Value, 1);
+    return Value;
+  }
+
+  if (!m_TileXSize)
+  {
+    computeTileSize();
+  }
+
+  const CacheTile& Tile = getTile(RasterBandIndex, ColIndex / m_TileXSize, LineIndex / m_TileYSize);
+
+  return Tile.Values[std::size_t(LineIndex % m_TileYSize) * Tile.XSize + (ColIndex % m_TileXSize)];
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+float RasterDataset::getValueOfCoordinate(geos::geom::Coordinate Coo,
+                                          unsigned int RasterBandIndex)
+{
+  std::pair<int, int> Pixel = getPixelFromCoordinate(Coo);
+
+  return getValueOfPixel(Pixel.first, Pixel.second, RasterBandIndex);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::getValuesOfCoordinates(const geos::geom::Coordinate* Coords, std::size_t Count, float* Values,
+                                           unsigned int RasterBandIndex)
+{
+  if (!Count)
+  {
+    return;
+  }
+
+  if (!rasterBand(RasterBandIndex))
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+  }
+
+  if (!mp_GeoTransform)
+  {
+    computeGeoTransform();
+  }
+
+  const double OriginX = mp_GeoTransform[0];
+  const double OriginY = mp_GeoTransform[3];
+  const double PixelWidth = mp_GeoTransform[1];
+  const double PixelHeight = mp_GeoTransform[5];
+  const int XSize = mp_Dataset->GetRasterXSize();
+  const int YSize = mp_Dataset->GetRasterYSize();
+
+  std::vector<int> Cols(Count);
+  std::vector<int> Lines(Count);
+
+  // branch-free transform, same rounding as getPixelFromCoordinate, which compilers can vectorize
+  for (std::size_t i = 0; i < Count; i++)
+  {
+    Cols[i] = int(std::floor((Coords[i].x - OriginX) / PixelWidth));
+    Lines[i] = int(std::floor((Coords[i].y - OriginY) / PixelHeight));
+  }
+
+  std::vector<std::size_t> Inside;
+  Inside.reserve(Count);
+
+  for (std::size_t i = 0; i < Count; i++)
+  {
+    if (Cols[i] < 0 || Lines[i] < 0 || Cols[i] >= XSize || Lines[i] >= YSize)
+    {
+      if (!m_OutOfExtentAsNaN)
+      {
+        throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+      }
+
+      Values[i] = std::numeric_limits<float>::quiet_NaN();
+    }
+    else
+    {
+      Inside.push_back(i);
+    }
+  }
+
+  if (Inside.size() == Count)
+  {
+    getValuesOfPixels(Cols.data(), Lines.data(), Count, Values, RasterBandIndex);
+    return;
+  }
+
+  // the coordinates outside of the raster are not read
+  std::vector<float> InsideValues(Inside.size());
+
+  for (std::size_t k = 0; k < Inside.size(); k++)
+  {
+    Cols[k] = Cols[Inside[k]];
+    Lines[k] = Lines[Inside[k]];
+  }
+
+  getValuesOfPixels(Cols.data(), Lines.data(), Inside.size(), InsideValues.data(), RasterBandIndex);
+
+  for (std::size_t k = 0; k < Inside.size(); k++)
+  {
+    Values[Inside[k]] = InsideValues[k];
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::getValuesOfPixels(const int* Cols, const int* Lines, std::size_t Count, float* Values,
+                                      unsigned int RasterBandIndex)
+{
+  DirectPixels Pixels;
+
+  if (getDirectPixels(RasterBandIndex, Pixels))
+  {
+    for (std::size_t i = 0; i < Count; i++)
+    {
+      GDALCopyWords(const_cast<unsigned char*>(Pixels.Data) + Lines[i] * Pixels.LineSpace +
+                    GIntBig(Cols[i]) * Pixels.PixelSpace,
+                    Pixels.DataType, 0, Values + i, GDT_Float32, 0, 1);
+    }
+
+    maskNoData(RasterBandIndex, Values, Count);
+
+    return;
+  }
+
+  if (!m_TileXSize)
+  {
+    computeTileSize();
+  }
+
+  const int TilesXCount = (mp_Dataset->GetRasterXSize() + m_TileXSize - 1) / m_TileXSize;
+  std::vector<std::uint64_t> TileOf(Count);
+
+  for (std::size_t i = 0; i < Count; i++)
+  {
+    TileOf[i] = std::uint64_t(Lines[i] / m_TileYSize) * TilesXCount + (Cols[i] / m_TileXSize);
+  }
+
+  std::vector<std::size_t> Order(Count);
+  for (std::size_t i = 0; i < Count; i++)
+  {
+    Order[i] = i;
+  }
+
+  std::sort(Order.begin(),Order.end(),[&TileOf](std::size_t A, std::size_t B)
+  {
+    return TileOf[A] < TileOf[B] || (TileOf[A] == TileOf[B] && A < B);
+  });
+
+  // each tile is fetched once for all the points it contains
+  std::size_t Begin = 0;
+
+  while (Begin < Count)
+  {
+    std::size_t End = Begin;
+    std::uint64_t Tile = TileOf[Order[Begin]];
+
+    while (End < Count && TileOf[Order[End]] == Tile)
+    {
+      End++;
+    }
+
+    const CacheTile& CachedTile = getTile(RasterBandIndex, int(Tile % TilesXCount), int(Tile / TilesXCount));
+
+    for (std::size_t k = Begin; k < End; k++)
+    {
+      std::size_t i = Order[k];
+      Values[i] = CachedTile.Values[std::size_t(Lines[i] % m_TileYSize) * CachedTile.XSize + (Cols[i] % m_TileXSize)];
+    }
+
+    Begin = End;
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::getInterpolatedValuesOfCoordinates(const geos::geom::Coordinate* Coords, std::size_t Count,
+                                                       float* Values, InterpolationMethod Method,
+                                                       unsigned int RasterBandIndex)
+{
+  if (Method == NEAREST)
+  {
+    getValuesOfCoordinates(Coords, Count, Values, RasterBandIndex);
+    return;
+  }
+
+  if (!Count)
+  {
+    return;
+  }
+
+  if (!rasterBand(RasterBandIndex))
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+  }
+
+  if (!mp_GeoTransform)
+  {
+    computeGeoTransform();
+  }
+
+  const double OriginX = mp_GeoTransform[0];
+  const double OriginY = mp_GeoTransform[3];
+  const double PixelWidth = mp_GeoTransform[1];
+  const double PixelHeight = mp_GeoTransform[5];
+  const int XSize = mp_Dataset->GetRasterXSize();
+  const int YSize = mp_Dataset->GetRasterYSize();
+
+  int HasNoData = 0;
+  const float NoData = float(rasterBand(RasterBandIndex)->GetNoDataValue(&HasNoData));
+
+  // kernel of 2x2 pixels for bilinear, 4x4 pixels for bicubic, centered on the sample
+  const int KernelSize = (Method == BICUBIC ? 4 : 2);
+  const std::size_t KernelPixels = KernelSize * KernelSize;
+
+  std::vector<int> Cols(Count * KernelPixels);
+  std::vector<int> Lines(Count * KernelPixels);
+  std::vector<double> Fx(Count);
+  std::vector<double> Fy(Count);
+  std::vector<char> Outside(Count,0);
+  std::size_t OutsideCount = 0;
+
+  for (std::size_t i = 0; i < Count; i++)
+  {
+    const double U = (Coords[i].x - OriginX) / PixelWidth;
+    const double V = (Coords[i].y - OriginY) / PixelHeight;
+
+    // same extent as getValuesOfCoordinates
+    if (U < 0 || V < 0 || int(U) >= XSize || int(V) >= YSize)
+    {
+      if (!m_OutOfExtentAsNaN)
+      {
+        throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+      }
+
+      // the kernel of an outside coordinate is set on the first pixel, its value is NaN anyway
+      Outside[i] = 1;
+      OutsideCount++;
+      std::fill(Cols.begin() + i * KernelPixels, Cols.begin() + (i + 1) * KernelPixels, 0);
+      std::fill(Lines.begin() + i * KernelPixels, Lines.begin() + (i + 1) * KernelPixels, 0);
+      continue;
+    }
+
+    // position relative to the pixel centers
+    const int FirstCol = int(std::floor(U - 0.5)) - (KernelSize/2 - 1);
+    const int FirstLine = int(std::floor(V - 0.5)) - (KernelSize/2 - 1);
+    Fx[i] = (U - 0.5) - std::floor(U - 0.5);
+    Fy[i] = (V - 0.5) - std::floor(V - 0.5);
+
+    // pixels beyond the raster edges are replaced by the edge pixels
+    for (int l = 0; l < KernelSize; l++)
+    {
+      for (int c = 0; c < KernelSize; c++)
+      {
+        Cols[i * KernelPixels + l * KernelSize + c] = std::min(std::max(FirstCol + c,0),XSize - 1);
+        Lines[i * KernelPixels + l * KernelSize + c] = std::min(std::max(FirstLine + l,0),YSize - 1);
+      }
+    }
+  }
+
+  if (OutsideCount == Count)
+  {
+    std::fill(Values, Values + Count, std::numeric_limits<float>::quiet_NaN());
+    return;
+  }
+
+  std::vector<float> Pixels(Count * KernelPixels);
+  getValuesOfPixels(Cols.data(), Lines.data(), Pixels.size(), Pixels.data(), RasterBandIndex);
+
+  auto isValid = [&](float Value)
+  {
+    return !std::isnan(Value) && !(HasNoData && Value == NoData);
+  };
+
+  // cubic convolution kernel, with a = -0.5
+  auto cubicWeight = [](double T)
+  {
+    T = std::fabs(T);
+
+    if (T <= 1)
+    {
+      return (1.5 * T - 2.5) * T * T + 1;
+    }
+    else if (T < 2)
+    {
+      return ((-0.5 * T + 2.5) * T - 4) * T + 2;
+    }
+
+    return 0.0;
+  };
+
+  for (std::size_t i = 0; i < Count; i++)
+  {
+    if (Outside[i])
+    {
+      Values[i] = std::numeric_limits<float>::quiet_NaN();
+      continue;
+    }
+
+    const float* Kernel = Pixels.data() + i * KernelPixels;
+    bool AllValid = true;
+
+    for (std::size_t k = 0; k < KernelPixels; k++)
+    {
+      AllValid = AllValid && isValid(Kernel[k]);
+    }
+
+    if (Method == BICUBIC && AllValid)
+    {
+      double Value = 0;
+
+      for (int l = 0; l < 4; l++)
+      {
+        for (int c = 0; c < 4; c++)
+        {
+          Value += cubicWeight(Fx[i] - (c - 1)) * cubicWeight(Fy[i] - (l - 1)) * Kernel[l * 4 + c];
+        }
+      }
+
+      Values[i] = float(Value);
+      continue;
+    }
+
+    // bilinear on the 2x2 central pixels, nodata pixels are left out and the other weights renormalized,
+    // which is also the fallback of bicubic near nodata
+    const int Offset = KernelSize/2 - 1;
+    double Value = 0;
+    double WeightsSum = 0;
+
+    for (int l = 0; l < 2; l++)
+    {
+      for (int c = 0; c < 2; c++)
+      {
+        float Pixel = Kernel[(Offset + l) * KernelSize + Offset + c];
+
+        if (isValid(Pixel))
+        {
+          double Weight = (c ? Fx[i] : 1 - Fx[i]) * (l ? Fy[i] : 1 - Fy[i]);
+          Value += Weight * Pixel;
+          WeightsSum += Weight;
+        }
+      }
+    }
+
+    Values[i] = (WeightsSum > 0 ? float(Value / WeightsSum) : std::numeric_limits<float>::quiet_NaN());
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+RasterDataset::ZonalStatistics::ZonalStatistics() :
+    Mean(std::numeric_limits<double>::quiet_NaN()), Min(std::numeric_limits<double>::quiet_NaN()),
+    Max(std::numeric_limits<double>::quiet_NaN()), Sum(0), Count(0),
+    StdDev(std::numeric_limits<double>::quiet_NaN()), CoveredArea(0)
+{
+
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+double RasterDataset::ZonalStatistics::get(Statistic Stat) const
+{
+  switch (Stat)
+  {
+    case MEAN:
+      return Mean;
+    case MIN:
+      return Min;
+    case MAX:
+      return Max;
+    case SUM:
+      return Sum;
+    case COUNT:
+      return Count;
+    case STDDEV:
+      return StdDev;
+  }
+
+  return std::numeric_limits<double>::quiet_NaN();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::visitZonePixels(const geos::geom::Geometry* Zone, const ZonePixelVisitor_t& Visitor,
+                                    bool ExactCoverage, unsigned int RasterBandIndex)
+{
+  visitZonePixels(Zone,std::vector<unsigned int>(1,RasterBandIndex),
+                  [&Visitor](int ColIndex, int LineIndex, const float* Values, double Coverage)
+  {
+    Visitor(ColIndex, LineIndex, Values[0], Coverage);
+  },ExactCoverage);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::visitZonePixels(const geos::geom::Geometry* Zone, const std::vector<unsigned int>& RasterBandIndexes,
+                                    const MultiBandZonePixelVisitor_t& Visitor, bool ExactCoverage)
+{
+  if (!Zone || Zone->isEmpty() || RasterBandIndexes.empty())
+  {
+    return;
+  }
+
+  if (Zone->getGeometryTypeId() != geos::geom::GEOS_POLYGON &&
+      Zone->getGeometryTypeId() != geos::geom::GEOS_MULTIPOLYGON)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Zone is not a Polygon or a MultiPolygon");
+  }
+
+  for (unsigned int RasterBandIndex : RasterBandIndexes)
+  {
+    if (!rasterBand(RasterBandIndex))
+    {
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+    }
+  }
+
+  if (!mp_GeoTransform)
+  {
+    computeGeoTransform();
+  }
+
+  // zones outside of the raster extent are skipped without reading the raster
+  if (!intersectsExtent(*Zone->getEnvelopeInternal()))
+  {
+    return;
+  }
+
+  const double OriginX = mp_GeoTransform[0];
+  const double OriginY = mp_GeoTransform[3];
+  const double PixelWidth = mp_GeoTransform[1];
+  const double PixelHeight = mp_GeoTransform[5];
+
+  // edges of all the rings of the zone, in pixel space (columns, lines)
+  struct PixelEdge
+  {
+    double C1, L1, C2, L2;
+  };
+
+  std::vector<PixelEdge> Edges;
+  double MinC = std::numeric_limits<double>::max(), MaxC = -std::numeric_limits<double>::max();
+  double MinL = std::numeric_limits<double>::max(), MaxL = -std::numeric_limits<double>::max();
+
+  for (std::size_t i = 0; i < Zone->getNumGeometries(); i++)
+  {
+    const geos::geom::Polygon* Poly = dynamic_cast<const geos::geom::Polygon*>(Zone->getGeometryN(i));
+
+    if (!Poly || Poly->isEmpty())
+    {
+      continue;
+    }
+
+    for (std::size_t r = 0; r <= Poly->getNumInteriorRing(); r++)
+    {
+      const geos::geom::LineString* Ring = (r == 0 ? Poly->getExteriorRing() : Poly->getInteriorRingN(r-1));
+      const geos::geom::CoordinateSequence* Coords = Ring->getCoordinatesRO();
+
+      for (std::size_t j = 1; j < Coords->size(); j++)
+      {
+        PixelEdge Edge = {(Coords->getAt(j-1).x - OriginX) / PixelWidth, (Coords->getAt(j-1).y - OriginY) / PixelHeight,
+                          (Coords->getAt(j).x - OriginX) / PixelWidth, (Coords->getAt(j).y - OriginY) / PixelHeight};
+        Edges.push_back(Edge);
+
+        MinC = std::min(MinC,std::min(Edge.C1,Edge.C2));
+        MaxC = std::max(MaxC,std::max(Edge.C1,Edge.C2));
+        MinL = std::min(MinL,std::min(Edge.L1,Edge.L2));
+        MaxL = std::max(MaxL,std::max(Edge.L1,Edge.L2));
+      }
+    }
+  }
+
+  if (Edges.empty())
+  {
+    return;
+  }
+
+  // window of the raster covered by the zone envelope
+  const int FirstCol = std::max(0,int(std::floor(MinC)));
+  const int LastCol = std::min(mp_Dataset->GetRasterXSize()-1,int(std::ceil(MaxC))-1);
+  const int FirstLine = std::max(0,int(std::floor(MinL)));
+  const int LastLine = std::min(mp_Dataset->GetRasterYSize()-1,int(std::ceil(MaxL))-1);
+
+  if (FirstCol > LastCol || FirstLine > LastLine)
+  {
+    return;
+  }
+
+  // pixels crossed by the boundary, by line, found by walking each edge over the grid
+  std::vector<std::vector<int>> BoundaryCols;
+
+  if (ExactCoverage)
+  {
+    BoundaryCols.resize(LastLine - FirstLine + 1);
+
+    auto markBoundary = [&](int Col, int Line)
+    {
+      if (Col >= FirstCol && Col <= LastCol && Line >= FirstLine && Line <= LastLine)
+      {
+        BoundaryCols[Line - FirstLine].push_back(Col);
+      }
+    };
+
+    const double Inf = std::numeric_limits<double>::infinity();
+
+    for (const PixelEdge& Edge : Edges)
+    {
+      int Col = int(std::floor(Edge.C1));
+      int Line = int(std::floor(Edge.L1));
+      const int EndCol = int(std::floor(Edge.C2));
+      const int EndLine = int(std::floor(Edge.L2));
+
+      const double DC = Edge.C2 - Edge.C1;
+      const double DL = Edge.L2 - Edge.L1;
+      const int StepCol = (DC > 0 ? 1 : -1);
+      const int StepLine = (DL > 0 ? 1 : -1);
+      const double DeltaCol = (DC != 0 ? 1 / std::fabs(DC) : Inf);
+      const double DeltaLine = (DL != 0 ? 1 / std::fabs(DL) : Inf);
+      double NextCol = (DC != 0 ? (DC > 0 ? Col + 1 - Edge.C1 : Edge.C1 - Col) * DeltaCol : Inf);
+      double NextLine = (DL != 0 ? (DL > 0 ? Line + 1 - Edge.L1 : Edge.L1 - Line) * DeltaLine : Inf);
+
+      int Steps = std::abs(EndCol - Col) + std::abs(EndLine - Line);
+
+      markBoundary(Col,Line);
+
+      while (Steps > 0)
+      {
+        if (NextCol < NextLine)
+        {
+          Col += StepCol;
+          NextCol += DeltaCol;
+        }
+        else if (NextLine < NextCol)
+        {
+          Line += StepLine;
+          NextLine += DeltaLine;
+        }
+        else
+        {
+          // the edge passes through a pixel corner, both neighbours are marked
+          markBoundary(Col + StepCol,Line);
+          markBoundary(Col,Line + StepLine);
+          Col += StepCol;
+          Line += StepLine;
+          NextCol += DeltaCol;
+          NextLine += DeltaLine;
+          Steps--;
+        }
+
+        Steps--;
+        markBoundary(Col,Line);
+      }
+
+      markBoundary(EndCol,EndLine);
+    }
+
+    for (std::vector<int>& Cols : BoundaryCols)
+    {
+      std::sort(Cols.begin(),Cols.end());
+      Cols.erase(std::unique(Cols.begin(),Cols.end()),Cols.end());
+    }
+  }
+
+  const double PixelArea = std::fabs(PixelWidth * PixelHeight);
+  const int WindowWidth = LastCol - FirstCol + 1;
+
+  const std::size_t BandsCount = RasterBandIndexes.size();
+
+  std::vector<float> LineValues(WindowWidth * BandsCount);
+  std::vector<double> Crossings;
+  std::vector<std::pair<int, double>> Covered;
+
+  for (int Line = FirstLine; Line <= LastLine; Line++)
+  {
+    const double CenterL = Line + 0.5;
+
+    Crossings.clear();
+
+    for (const PixelEdge& Edge : Edges)
+    {
+      if ((Edge.L1 <= CenterL) != (Edge.L2 <= CenterL))
+      {
+        Crossings.push_back(Edge.C1 + (CenterL - Edge.L1) * (Edge.C2 - Edge.C1) / (Edge.L2 - Edge.L1));
+      }
+    }
+
+    std::sort(Crossings.begin(),Crossings.end());
+
+    static const std::vector<int> NoBoundary;
+    const std::vector<int>& Boundary = (ExactCoverage ? BoundaryCols[Line - FirstLine] : NoBoundary);
+    std::vector<int>::const_iterator itBoundary = Boundary.begin();
+
+    Covered.clear();
+
+    // pixels with center inside the zone (even-odd rule), the boundary pixels are clipped below
+    for (std::size_t k = 0; k + 1 < Crossings.size(); k += 2)
+    {
+      const int SpanFirst = std::max(FirstCol,int(std::ceil(Crossings[k] - 0.5)));
+      const int SpanLast = std::min(LastCol,int(std::ceil(Crossings[k+1] - 0.5)) - 1);
+
+      for (int Col = SpanFirst; Col <= SpanLast; Col++)
+      {
+        while (itBoundary != Boundary.end() && *itBoundary < Col)
+        {
+          ++itBoundary;
+        }
+
+        if (itBoundary == Boundary.end() || *itBoundary != Col)
+        {
+          Covered.push_back(std::make_pair(Col,1.0));
+        }
+      }
+    }
+
+    if (!Boundary.empty())
+    {
+      const double LineY1 = OriginY + Line * PixelHeight;
+      const double LineY2 = OriginY + (Line + 1) * PixelHeight;
+
+      // the zone is first clipped to the line, so that each pixel clipping only involves the local boundary
+      geos::operation::intersection::Rectangle LineRect(
+          std::min(OriginX + FirstCol * PixelWidth,OriginX + (LastCol + 1) * PixelWidth),std::min(LineY1,LineY2),
+          std::max(OriginX + FirstCol * PixelWidth,OriginX + (LastCol + 1) * PixelWidth),std::max(LineY1,LineY2));
+      std::unique_ptr<geos::geom::Geometry> LineZone =
+          geos::operation::intersection::RectangleIntersection::clip(*Zone,LineRect);
+
+      for (int Col : Boundary)
+      {
+        const double PixelX1 = OriginX + Col * PixelWidth;
+        const double PixelX2 = OriginX + (Col + 1) * PixelWidth;
+
+        geos::operation::intersection::Rectangle PixelRect(std::min(PixelX1,PixelX2),std::min(LineY1,LineY2),
+                                                           std::max(PixelX1,PixelX2),std::max(LineY1,LineY2));
+
+        double Coverage =
+            geos::operation::intersection::RectangleIntersection::clip(*LineZone,PixelRect)->getArea() / PixelArea;
+
+        if (Coverage > 0)
+        {
+          Covered.push_back(std::make_pair(Col,std::min(Coverage,1.0)));
+        }
+      }
+
+      std::sort(Covered.begin(),Covered.end());
+    }
+
+    if (Covered.empty())
+    {
+      continue;
+    }
+
+    if (readRasterWindow(RasterBandIndexes, FirstCol, Line, WindowWidth, 1, LineValues.data()) != CE_None)
+    {
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+    }
+
+    for (const std::pair<int, double>& Pixel : Covered)
+    {
+      Visitor(Pixel.first, Line, LineValues.data() + (Pixel.first - FirstCol) * BandsCount, Pixel.second);
+    }
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+RasterDataset::ZonalStatistics RasterDataset::computeZonalStatistics(const geos::geom::Geometry* Zone,
+                                                                     bool ExactCoverage,
+                                                                     unsigned int RasterBandIndex)
+{
+  return computeZonalStatistics(Zone,std::vector<unsigned int>(1,RasterBandIndex),ExactCoverage).front();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::vector<RasterDataset::ZonalStatistics> RasterDataset::computeZonalStatistics(
+    const geos::geom::Geometry* Zone, const std::vector<unsigned int>& RasterBandIndexes, bool ExactCoverage)
+{
+  const std::size_t BandsCount = RasterBandIndexes.size();
+
+  std::vector<ZonalStatistics> Stats(BandsCount);
+  std::vector<int> HasNoData(BandsCount,0);
+  std::vector<float> NoData(BandsCount);
+
+  for (std::size_t b = 0; b < BandsCount; b++)
+  {
+    GDALRasterBand* Band = rasterBand(RasterBandIndexes[b]);
+
+    if (!Band)
+    {
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+    }
+
+    NoData[b] = float(Band->GetNoDataValue(&HasNoData[b]));
+  }
+
+  const double PixelArea = std::fabs(getPixelWidth() * getPixelHeight());
+
+  std::vector<double> Means(BandsCount,0);
+  std::vector<double> SquaresSums(BandsCount,0);
+
+  // weighted incremental mean and variance (West algorithm), for all the bands in the same pass
+  visitZonePixels(Zone,RasterBandIndexes,[&](int /*ColIndex*/, int /*LineIndex*/, const float* Values, double Coverage)
+  {
+    for (std::size_t b = 0; b < BandsCount; b++)
+    {
+      const float Value = Values[b];
+      ZonalStatistics& BandStats = Stats[b];
+
+      if (std::isnan(Value) || (HasNoData[b] && Value == NoData[b]))
+      {
+        continue;
+      }
+
+      if (!BandStats.Count)
+      {
+        BandStats.Min = Value;
+        BandStats.Max = Value;
+      }
+      else
+      {
+        BandStats.Min = std::min(BandStats.Min,double(Value));
+        BandStats.Max = std::max(BandStats.Max,double(Value));
+      }
+
+      BandStats.Count += Coverage;
+      BandStats.Sum += Coverage * Value;
+
+      const double Delta = Value - Means[b];
+      Means[b] += (Coverage / BandStats.Count) * Delta;
+      SquaresSums[b] += Coverage * Delta * (Value - Means[b]);
+    }
+  },ExactCoverage);
+
+  for (std::size_t b = 0; b < BandsCount; b++)
+  {
+    if (Stats[b].Count > 0)
+    {
+      Stats[b].Mean = Means[b];
+      Stats[b].StdDev = std::sqrt(std::max(0.0,SquaresSums[b] / Stats[b].Count));
+      Stats[b].CoveredArea = Stats[b].Count * PixelArea;
+    }
+  }
+
+  return Stats;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+const std::vector<int>& RasterDataset::overviewsXSizes()
+{
+  if (!m_OverviewsXSizesLoaded)
+  {
+    m_OverviewsXSizes.clear();
+
+    GDALDataset* Source = m_SourcePath.empty() ? nullptr :
+                                                 static_cast<GDALDataset*>(GDALOpen(m_SourcePath.c_str(), GA_ReadOnly));
+
+    if (Source)
+    {
+      GDALRasterBand* Band = Source->GetRasterBand(1);
+
+      for (int i = 0; Band && i < Band->GetOverviewCount(); i++)
+      {
+        m_OverviewsXSizes.push_back(Band->GetOverview(i)->GetXSize());
+      }
+
+      GDALClose(Source);
+    }
+
+    m_OverviewsXSizesLoaded = true;
+  }
+
+  return m_OverviewsXSizes;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+unsigned int RasterDataset::getOverviewsCount()
+{
+  return overviewsXSizes().size();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::buildOverviews(const std::string& Resampling)
+{
+  if (m_SourcePath.empty())
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "No source file to build overviews for");
+  }
+
+  const int MaxSize = std::max(mp_Dataset->GetRasterXSize(),mp_Dataset->GetRasterYSize());
+
+  // down to overviews of a few pixels
+  std::vector<int> Factors;
+
+  for (int Factor = 2; MaxSize / Factor >= 8; Factor *= 2)
+  {
+    Factors.push_back(Factor);
+  }
+
+  if (Factors.empty())
+  {
+    return;
+  }
+
+  // opened read-only, the overviews are written in an external .ovr file
+  GDALDataset* Source = static_cast<GDALDataset*>(GDALOpen(m_SourcePath.c_str(), GA_ReadOnly));
+
+  if (!Source)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while opening " + m_SourcePath);
+  }
+
+  CPLErr Err = Source->BuildOverviews(Resampling.c_str(), int(Factors.size()), Factors.data(), 0, nullptr,
+                                      nullptr, nullptr);
+
+  GDALClose(Source);
+
+  m_Overviews.clear();
+  m_OverviewsXSizesLoaded = false;
+
+  if (Err != CE_None)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Error while building overviews of " + m_SourcePath +
+                                              " (" + CPLGetLastErrorMsg() + ")");
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+RasterDataset& RasterDataset::overview(unsigned int Level)
+{
+  if (!Level)
+  {
+    return *this;
+  }
+
+  std::map<unsigned int, std::unique_ptr<RasterDataset>>::iterator it = m_Overviews.find(Level);
+
+  if (it != m_Overviews.end())
+  {
+    return *(it->second);
+  }
+
+  if (Level > getOverviewsCount())
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Overview level does not exist");
+  }
+
+#if (GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(2,2,0))
+  const std::string LevelOption = "OVERVIEW_LEVEL=" + std::to_string(Level - 1);
+  const char* OpenOptions[] = {LevelOption.c_str(), nullptr};
+
+  GDALDataset* DS = static_cast<GDALDataset*>(GDALOpenEx(m_SourcePath.c_str(), GDAL_OF_RASTER | GDAL_OF_READONLY,
+                                                         nullptr, OpenOptions, nullptr));
+
+  if (!DS)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Error while opening overview of " + m_SourcePath +
+                                              " (" + CPLGetLastErrorMsg() + ")");
+  }
+
+  RasterDataset* Overview = new RasterDataset(DS);
+  m_Overviews[Level].reset(Overview);
+
+  Overview->setOutOfExtentPolicy(getOutOfExtentPolicy());
+  Overview->setNoDataPolicy(getNoDataPolicy());
+
+  return *Overview;
+#else
+  throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Overviews require GDAL 2.2 or later");
+#endif
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+unsigned int RasterDataset::selectOverviewLevel(double ZoneArea, double Accuracy, bool BuildMissing)
+{
+  if (Accuracy <= 0 || ZoneArea <= 0)
+  {
+    return 0;
+  }
+
+  const double MaxPixelSide = Accuracy * std::sqrt(ZoneArea);
+  const double PixelSide = std::sqrt(std::fabs(getPixelWidth() * getPixelHeight()));
+
+  if (PixelSide >= MaxPixelSide)
+  {
+    return 0;
+  }
+
+  if (BuildMissing && !m_SourcePath.empty() && overviewsXSizes().empty())
+  {
+    buildOverviews();
+  }
+
+  const std::vector<int>& XSizes = overviewsXSizes();
+  const double XSize = mp_Dataset->GetRasterXSize();
+
+  unsigned int Level = 0;
+
+  for (unsigned int i = 0; i < XSizes.size(); i++)
+  {
+    if (PixelSide * (XSize / XSizes[i]) > MaxPixelSide)
+    {
+      break;
+    }
+
+    Level = i + 1;
+  }
+
+  return Level;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::runOnCopies(unsigned int TasksCount,
+                                const std::function<void(unsigned int, RasterDataset&)>& Task,
+                                unsigned int ThreadsCount)
+{
+  if (!ThreadsCount)
+  {
+    ThreadsCount = std::max(1u,std::thread::hardware_concurrency());
+  }
+
+  ThreadsCount = std::min(ThreadsCount,TasksCount);
+
+  std::vector<std::unique_ptr<RasterDataset>> Copies;
+  std::vector<RasterDataset*> FreeRasters;
+  std::mutex RastersMutex;
+
+  for (unsigned int i = 1; i < ThreadsCount; i++)
+  {
+    Copies.emplace_back(new RasterDataset(*this));
+    FreeRasters.push_back(Copies.back().get());
+  }
+
+  FreeRasters.push_back(this);
+
+  LandRTools::runInParallel(TasksCount,[&](unsigned int i)
+  {
+    RasterDataset* Raster;
+
+    {
+      std::lock_guard<std::mutex> Lock(RastersMutex);
+      Raster = FreeRasters.back();
+      FreeRasters.pop_back();
+    }
+
+    try
+    {
+      Task(i,*Raster);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> Lock(RastersMutex);
+      FreeRasters.push_back(Raster);
+      throw;
+    }
+
+    std::lock_guard<std::mutex> Lock(RastersMutex);
+    FreeRasters.push_back(Raster);
+  },ThreadsCount);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::string RasterDataset::m_PolygonizedCachePath;
+
+double RasterDataset::m_PolygonizedCacheLockTimeout = 60;
+
+
+// =====================================================================
+// =====================================================================
+
+
+/**
+  @brief A lock on an entry of the polygonized cache, shared between processes.
+  @details The lock is a directory, whose creation is atomic, holding a file with the token of its owner.
+  The owner rewrites this file periodically from a background thread while it holds the lock,
+  so that a lock whose file is older than the lock timeout is known as left by a dead process.
+  An owner which finds another token in the file has lost its lock, and stops touching it.
+*/
+class RasterDataset::PolygonizedCacheLock
+{
+  private:
+
+    std::string m_LockPath;
+
+    std::string m_OwnerPath;
+
+    std::string m_Token;
+
+    bool m_IsOwner;
+
+    std::thread m_Heartbeat;
+
+    std::mutex m_HeartbeatMutex;
+
+    std::condition_variable m_HeartbeatStop;
+
+    bool m_IsStopping;
+
+    bool m_IsLost;
+
+    bool writeOwner()
+    {
+      VSILFILE* File = VSIFOpenL(m_OwnerPath.c_str(),"wb");
+
+      if (!File)
+      {
+        return false;
+      }
+
+      bool Written = (VSIFWriteL(m_Token.data(),1,m_Token.size(),File) == m_Token.size());
+      VSIFCloseL(File);
+
+      return Written;
+    }
+
+    std::string readOwner()
+    {
+      VSILFILE* File = VSIFOpenL(m_OwnerPath.c_str(),"rb");
+
+      if (!File)
+      {
+        return "";
+      }
+
+      char Buffer[128];
+      std::size_t ReadSize = VSIFReadL(Buffer,1,sizeof(Buffer),File);
+      VSIFCloseL(File);
+
+      return std::string(Buffer,ReadSize);
+    }
+
+
+  public:
+
+    PolygonizedCacheLock(const std::string& LockPath) :
+      m_LockPath(LockPath), m_OwnerPath(CPLFormFilename(LockPath.c_str(),"owner",nullptr)),
+      m_IsOwner(false), m_IsStopping(false), m_IsLost(false)
+    {
+      std::ostringstream Token;
+      Token << CPLGetPID() << "_" << std::this_thread::get_id() << "_"
+            << std::chrono::steady_clock::now().time_since_epoch().count();
+      m_Token = Token.str();
+    }
+
+    ~PolygonizedCacheLock()
+    {
+      release();
+    }
+
+    bool isOwner() const
+    {
+      return m_IsOwner;
+    }
+
+    /**
+      @brief Tries once to take the lock, breaking it if it is stale.
+      @return True if the lock is now owned.
+    */
+    bool tryAcquire()
+    {
+      if (VSIMkdir(m_LockPath.c_str(),0755) == 0)
+      {
+        if (!writeOwner())
+        {
+          CPLUnlinkTree(m_LockPath.c_str());
+          return false;
+        }
+
+        m_IsOwner = true;
+        m_IsStopping = false;
+        m_IsLost = false;
+
+        const double Period = std::max(0.1,m_PolygonizedCacheLockTimeout / 4);
+
+        m_Heartbeat = std::thread([this,Period]()
+        {
+          std::unique_lock<std::mutex> Lock(m_HeartbeatMutex);
+
+          while (!m_HeartbeatStop.wait_for(Lock,std::chrono::duration<double>(Period),
+                                           [this]() { return m_IsStopping; }))
+          {
+            // the lock has been broken by another process, which now owns it
+            if (readOwner() != m_Token)
+            {
+              m_IsLost = true;
+              return;
+            }
+
+            writeOwner();
+          }
+        });
+
+        return true;
+      }
+
+      // the owner file may not be written yet by a live owner, or ever by a dead one
+      VSIStatBufL Stat;
+
+      if (VSIStatL(m_OwnerPath.c_str(),&Stat) != 0 && VSIStatL(m_LockPath.c_str(),&Stat) != 0)
+      {
+        return false;
+      }
+
+      if (std::difftime(std::time(nullptr),Stat.st_mtime) < m_PolygonizedCacheLockTimeout)
+      {
+        return false;
+      }
+
+      // the stale lock is renamed before being removed, so that only one process breaks it,
+      // the lock is then taken by the next attempt
+      const std::string StalePath = m_LockPath + ".stale_" + m_Token;
+
+      if (VSIRename(m_LockPath.c_str(),StalePath.c_str()) == 0)
+      {
+        CPLUnlinkTree(StalePath.c_str());
+      }
+
+      return false;
+    }
+
+    void release()
+    {
+      if (!m_IsOwner)
+      {
+        return;
+      }
+
+      {
+        std::lock_guard<std::mutex> Lock(m_HeartbeatMutex);
+        m_IsStopping = true;
+      }
+      m_HeartbeatStop.notify_all();
+      m_Heartbeat.join();
+
+      // a lock broken by another process is not removed
+      if (!m_IsLost && readOwner() == m_Token)
+      {
+        CPLUnlinkTree(m_LockPath.c_str());
+      }
+
+      m_IsOwner = false;
+    }
+};
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::setPolygonizedCachePath(const std::string& Path)
+{
+  m_PolygonizedCachePath = Path;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::string RasterDataset::getPolygonizedCachePath()
+{
+  return m_PolygonizedCachePath;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::setPolygonizedCacheLockTimeout(double Seconds)
+{
+  m_PolygonizedCacheLockTimeout = Seconds;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+double RasterDataset::getPolygonizedCacheLockTimeout()
+{
+  return m_PolygonizedCacheLockTimeout;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::string RasterDataset::computeContentHash(unsigned int RasterBandIndex)
+{
+  std::map<unsigned int, std::string>::const_iterator itHash = m_ContentHashes.find(RasterBandIndex);
+
+  if (itHash != m_ContentHashes.end())
+  {
+    return itHash->second;
+  }
+
+  GDALRasterBand* Band = rasterBand(RasterBandIndex);
+
+  if (!Band)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+  }
+
+  // 64 bits FNV-1a
+  std::uint64_t Hash = 14695981039346656037ULL;
+
+  auto hashBytes = [&Hash](const void* Data, std::size_t Size)
+  {
+    const unsigned char* Bytes = static_cast<const unsigned char*>(Data);
+
+    for (std::size_t i = 0; i < Size; i++)
+    {
+      Hash ^= Bytes[i];
+      Hash *= 1099511628211ULL;
+    }
+  };
+
+  if (!mp_GeoTransform)
+  {
+    computeGeoTransform();
+  }
+
+  const int XSize = mp_Dataset->GetRasterXSize();
+  const int YSize = mp_Dataset->GetRasterYSize();
+  const GDALDataType DataType = Band->GetRasterDataType();
+  int HasNoData = 0;
+  const double NoData = Band->GetNoDataValue(&HasNoData);
+
+  hashBytes(&XSize,sizeof(XSize));
+  hashBytes(&YSize,sizeof(YSize));
+  hashBytes(&DataType,sizeof(DataType));
+  hashBytes(mp_GeoTransform,6*sizeof(double));
+  hashBytes(&HasNoData,sizeof(HasNoData));
+  if (HasNoData)
+  {
+    hashBytes(&NoData,sizeof(NoData));
+  }
+
+  // the pixels are hashed in their own data type, line by line
+  std::vector<unsigned char> LineBytes(std::size_t(XSize) * (GDALGetDataTypeSize(DataType) / 8));
+
+  for (int Line = 0; Line < YSize; Line++)
+  {
+    if (Band->RasterIO(GF_Read, 0, Line, XSize, 1, LineBytes.data(), XSize, 1, DataType, 0, 0) != CE_None)
+    {
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+    }
+
+    hashBytes(LineBytes.data(),LineBytes.size());
+  }
+
+  std::ostringstream HashStr;
+  HashStr << std::hex << std::setw(16) << std::setfill('0') << Hash;
+
+  m_ContentHashes[RasterBandIndex] = HashStr.str();
+
+  return HashStr.str();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool RasterDataset::loadCachedPolygonized(const std::string& EntryPath, const std::string& FileName,
+                                          const std::string& FieldName, unsigned int RasterBandIndex)
+{
+  const std::string CachedPath = CPLFormFilename(EntryPath.c_str(),"polygonized.shp",nullptr);
+
+  VSIStatBufL Stat;
+
+  if (VSIStatL(CachedPath.c_str(),&Stat) != 0)
+  {
+    return false;
+  }
+
+  GDALDataset_COMPAT* CachedDS = GDALOpenRO_COMPAT(CachedPath.c_str());
+
+  if (!CachedDS)
+  {
+    return false;
+  }
+
+  openfluid::landr::VectorDataset* Polygonized = new openfluid::landr::VectorDataset(FileName);
+
+  Polygonized->addALayer("",wkbPolygon);
+  Polygonized->addAField(FieldName,OFTReal);
+
+  OGRLayer* CachedLayer = CachedDS->GetLayer(0);
+  OGRLayer* Layer = Polygonized->layer(0);
+  OGRFeature* CachedFeat;
+
+  CachedLayer->ResetReading();
+
+  while ((CachedFeat = CachedLayer->GetNextFeature()) != nullptr)
+  {
+    OGRFeature* Feat = OGRFeature::CreateFeature(Layer->GetLayerDefn());
+    Feat->SetFrom(CachedFeat);
+
+    OGRErr Err = Layer->CreateFeature(Feat);
+
+    OGRFeature::DestroyFeature(Feat);
+    OGRFeature::DestroyFeature(CachedFeat);
+
+    if (Err != OGRERR_NONE)
+    {
+      GDALClose_COMPAT(CachedDS);
+      delete Polygonized;
+      return false;
+    }
+  }
+
+  GDALClose_COMPAT(CachedDS);
+
+  mp_PolygonizedByRasterBandIndex.insert(std::make_pair(RasterBandIndex,Polygonized));
+
+  return true;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::storeCachedPolygonized(const std::string& EntryPath, unsigned int RasterBandIndex)
+{
+  // the entry is written aside then renamed, so that other processes never see a partial entry
+  const std::string WritingPath = EntryPath + ".tmp_" + std::to_string(CPLGetPID());
+
+  CPLUnlinkTree(WritingPath.c_str());
+
+  try
+  {
+    mp_PolygonizedByRasterBandIndex.at(RasterBandIndex)->copyToDisk(WritingPath,"polygonized.shp",true);
+  }
+  catch (openfluid::base::FrameworkException&)
+  {
+    CPLUnlinkTree(WritingPath.c_str());
+    throw;
+  }
+
+  if (VSIRename(WritingPath.c_str(),EntryPath.c_str()) != 0)
+  {
+    CPLUnlinkTree(WritingPath.c_str());
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::polygonizeInTiles(OGRLayer* Layer, int FieldIndex, unsigned int RasterBandIndex,
+                                      unsigned int TileSize, unsigned int ThreadsCount)
+{
+  if (!rasterBand(RasterBandIndex))
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+  }
+
+  if (!mp_GeoTransform)
+  {
+    computeGeoTransform();
+  }
+
+  const int XSize = mp_Dataset->GetRasterXSize();
+  const int YSize = mp_Dataset->GetRasterYSize();
+  const int Size = int(TileSize);
+  const int TilesXCount = (XSize + Size - 1) / Size;
+  const int TilesYCount = (YSize + Size - 1) / Size;
+  const unsigned int TilesCount = unsigned(TilesXCount * TilesYCount);
+
+  GDALDriver* RasterMemDriver = static_cast<GDALDriver*>(GDALGetDriverByName("MEM"));
+
+#if (GDAL_VERSION_MAJOR >= 2)
+  GDALDriver_COMPAT* VectorMemDriver = GetGDALDriverManager()->GetDriverByName("Memory");
+#else
+  GDALDriver_COMPAT* VectorMemDriver = OGRSFDriverRegistrar::GetRegistrar()->GetDriverByName("Memory");
+#endif
+
+  if (!RasterMemDriver || !VectorMemDriver)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "GDAL memory drivers not available.");
+  }
+
+  struct TilePolygon
+  {
+    std::unique_ptr<OGRPolygon> Polygon;
+
+    double Value;
+
+    unsigned int Tile;
+  };
+
+  std::vector<std::vector<TilePolygon>> TilesPolygons(TilesCount);
+
+  runOnCopies(TilesCount,[&](unsigned int Tile, RasterDataset& Raster)
+  {
+    const int FirstCol = int(Tile % TilesXCount) * Size;
+    const int FirstLine = int(Tile / TilesXCount) * Size;
+    const int Width = std::min(Size,XSize - FirstCol);
+    const int Height = std::min(Size,YSize - FirstLine);
+
+    std::vector<float> Values(std::size_t(Width) * Height);
+
+    if (Raster.readRasterWindow(RasterBandIndex, FirstCol, FirstLine, Width, Height, Values.data()) != CE_None)
+    {
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+    }
+
+    // the tile is polygonized in pixel coordinates of the whole raster, which are exact at the seams
+    GDALDataset* TileDS = RasterMemDriver->Create("", Width, Height, 1, GDT_Float32, nullptr);
+    double TileTransform[6] = {double(FirstCol), 1, 0, double(FirstLine), 0, 1};
+
+    GDALDataset_COMPAT* TileVectorDS = GDALCreate_COMPAT(VectorMemDriver,"");
+
+    if (!TileDS || !TileVectorDS)
+    {
+      if (TileDS)
+      {
+        GDALClose(TileDS);
+      }
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while polygonizing raster.");
+    }
+
+    TileDS->SetGeoTransform(TileTransform);
+
+    OGRLayer* TileLayer = TileVectorDS->CreateLayer("tile", nullptr, wkbPolygon, nullptr);
+    OGRFieldDefn ValueField("Value",OFTReal);
+
+    bool Polygonized =
+      TileLayer && TileLayer->CreateField(&ValueField) == OGRERR_NONE &&
+      TileDS->GetRasterBand(1)->RasterIO(GF_Write, 0, 0, Width, Height, Values.data(), Width, Height, GDT_Float32,
+                                         0, 0) == CE_None &&
+      GDALFPolygonize(TileDS->GetRasterBand(1), nullptr, TileLayer, 0, nullptr, nullptr, nullptr) == CE_None;
+
+    if (Polygonized)
+    {
+      OGRFeature* Feat;
+
+      TileLayer->ResetReading();
+
+      while ((Feat = TileLayer->GetNextFeature()) != nullptr)
+      {
+        OGRGeometry* Geom = Feat->StealGeometry();
+
+        if (Geom && wkbFlatten(Geom->getGeometryType()) == wkbPolygon)
+        {
+          TilesPolygons[Tile].push_back({std::unique_ptr<OGRPolygon>(static_cast<OGRPolygon*>(Geom)),
+                                         Feat->GetFieldAsDouble(0), Tile});
+        }
+        else
+        {
+          delete Geom;
+        }
+
+        OGRFeature::DestroyFeature(Feat);
+      }
+    }
+
+    GDALClose_COMPAT(TileVectorDS);
+    GDALClose(TileDS);
+
+    if (!Polygonized)
+    {
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while polygonizing raster.");
+    }
+  },ThreadsCount);
+
+  std::vector<TilePolygon> Polygons;
+
+  for (std::vector<TilePolygon>& TilePolygons : TilesPolygons)
+  {
+    std::move(TilePolygons.begin(),TilePolygons.end(),std::back_inserter(Polygons));
+  }
+
+  TilesPolygons.clear();
+
+  // boundary segments of the polygons lying on the tile seams,
+  // by orientation (0 for vertical, 1 for horizontal), seam position and side of the seam
+  struct SeamSegment
+  {
+    double Start;
+
+    double End;
+
+    std::size_t Polygon;
+  };
+
+  std::map<std::tuple<int,int,int>, std::vector<SeamSegment>> SeamsSegments;
+
+  for (std::size_t i = 0; i < Polygons.size(); i++)
+  {
+    const int FirstCol = int(Polygons[i].Tile % TilesXCount) * Size;
+    const int FirstLine = int(Polygons[i].Tile / TilesXCount) * Size;
+    const int LastCol = std::min(FirstCol + Size,XSize);
+    const int LastLine = std::min(FirstLine + Size,YSize);
+
+    const OGRLinearRing* Ring = Polygons[i].Polygon->getExteriorRing();
+
+    for (int p = 0; p + 1 < Ring->getNumPoints(); p++)
+    {
+      const double X1 = Ring->getX(p), Y1 = Ring->getY(p);
+      const double X2 = Ring->getX(p+1), Y2 = Ring->getY(p+1);
+
+      if (X1 == X2 && Y1 != Y2)
+      {
+        if (X1 == FirstCol && FirstCol > 0)
+        {
+          SeamsSegments[std::make_tuple(0,FirstCol,1)].push_back({std::min(Y1,Y2),std::max(Y1,Y2),i});
+        }
+        else if (X1 == LastCol && LastCol < XSize)
+        {
+          SeamsSegments[std::make_tuple(0,LastCol,0)].push_back({std::min(Y1,Y2),std::max(Y1,Y2),i});
+        }
+      }
+      else if (Y1 == Y2 && X1 != X2)
+      {
+        if (Y1 == FirstLine && FirstLine > 0)
+        {
+          SeamsSegments[std::make_tuple(1,FirstLine,1)].push_back({std::min(X1,X2),std::max(X1,X2),i});
+        }
+        else if (Y1 == LastLine && LastLine < YSize)
+        {
+          SeamsSegments[std::make_tuple(1,LastLine,0)].push_back({std::min(X1,X2),std::max(X1,X2),i});
+        }
+      }
+    }
+  }
+
+  // polygons of the same value sharing a seam segment belong to the same region (union-find)
+  std::vector<std::size_t> Parents(Polygons.size());
+
+  for (std::size_t i = 0; i < Parents.size(); i++)
+  {
+    Parents[i] = i;
+  }
+
+  auto findRoot = [&Parents](std::size_t i)
+  {
+    while (Parents[i] != i)
+    {
+      Parents[i] = Parents[Parents[i]];
+      i = Parents[i];
+    }
+    return i;
+  };
+
+  // NaN pixels form regions too, which have to be merged across the seams as well
+  auto isSameValue = [](double A, double B)
+  {
+    return A == B || (std::isnan(A) && std::isnan(B));
+  };
+
+  auto sortByStart = [](const SeamSegment& A, const SeamSegment& B)
+  {
+    return A.Start < B.Start;
+  };
+
+  for (auto& Seam : SeamsSegments)
+  {
+    if (std::get<2>(Seam.first) != 0)
+    {
+      continue;
+    }
+
+    std::map<std::tuple<int,int,int>, std::vector<SeamSegment>>::iterator itOther =
+        SeamsSegments.find(std::make_tuple(std::get<0>(Seam.first),std::get<1>(Seam.first),1));
+
+    if (itOther == SeamsSegments.end())
+    {
+      continue;
+    }
+
+    std::vector<SeamSegment>& Before = Seam.second;
+    std::vector<SeamSegment>& After = itOther->second;
+
+    std::sort(Before.begin(),Before.end(),sortByStart);
+    std::sort(After.begin(),After.end(),sortByStart);
+
+    std::size_t b = 0, a = 0;
+
+    while (b < Before.size() && a < After.size())
+    {
+      if (std::max(Before[b].Start,After[a].Start) < std::min(Before[b].End,After[a].End) &&
+          isSameValue(Polygons[Before[b].Polygon].Value,Polygons[After[a].Polygon].Value))
+      {
+        Parents[findRoot(Before[b].Polygon)] = findRoot(After[a].Polygon);
+      }
+
+      if (Before[b].End < After[a].End)
+      {
+        b++;
+      }
+      else
+      {
+        a++;
+      }
+    }
+  }
+
+  std::vector<std::vector<std::size_t>> Regions(Polygons.size());
+  std::vector<std::size_t> RegionsOrder;
+
+  for (std::size_t i = 0; i < Polygons.size(); i++)
+  {
+    std::size_t Root = findRoot(i);
+
+    if (Regions[Root].empty())
+    {
+      RegionsOrder.push_back(Root);
+    }
+
+    Regions[Root].push_back(i);
+  }
+
+  const double* GT = mp_GeoTransform;
+
+  auto toGeoCoordinates = [GT](OGRLinearRing* Ring)
+  {
+    for (int p = 0; p < Ring->getNumPoints(); p++)
+    {
+      const double X = Ring->getX(p);
+      const double Y = Ring->getY(p);
+
+      Ring->setPoint(p, GT[0] + X * GT[1] + Y * GT[2], GT[3] + X * GT[4] + Y * GT[5]);
+    }
+  };
+
+  auto writePolygon = [&](OGRPolygon* Polygon, double Value)
+  {
+    toGeoCoordinates(Polygon->getExteriorRing());
+
+    for (int r = 0; r < Polygon->getNumInteriorRings(); r++)
+    {
+      toGeoCoordinates(Polygon->getInteriorRing(r));
+    }
+
+    OGRFeature* Feat = OGRFeature::CreateFeature(Layer->GetLayerDefn());
+    Feat->SetField(FieldIndex,Value);
+    Feat->SetGeometryDirectly(Polygon);
+
+    OGRErr Err = Layer->CreateFeature(Feat);
+
+    OGRFeature::DestroyFeature(Feat);
+
+    if (Err != OGRERR_NONE)
+    {
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while polygonizing raster.");
+    }
+  };
+
+  for (std::size_t Root : RegionsOrder)
+  {
+    const double Value = Polygons[Root].Value;
+
+    if (Regions[Root].size() == 1)
+    {
+      writePolygon(Polygons[Root].Polygon.release(),Value);
+      continue;
+    }
+
+    // the parts of a region spread over several tiles are dissolved along their shared seam segments
+    OGRMultiPolygon Parts;
+
+    for (std::size_t i : Regions[Root])
+    {
+      Parts.addGeometryDirectly(Polygons[i].Polygon.release());
+    }
+
+    std::unique_ptr<OGRGeometry> Region(Parts.UnionCascaded());
+
+    if (!Region)
+    {
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while polygonizing raster.");
+    }
+
+    if (wkbFlatten(Region->getGeometryType()) == wkbPolygon)
+    {
+      writePolygon(static_cast<OGRPolygon*>(Region.release()),Value);
+    }
+    else if (wkbFlatten(Region->getGeometryType()) == wkbMultiPolygon)
+    {
+      OGRMultiPolygon* RegionParts = static_cast<OGRMultiPolygon*>(Region.get());
+
+      while (RegionParts->getNumGeometries())
+      {
+        OGRPolygon* Part = static_cast<OGRPolygon*>(RegionParts->getGeometryRef(0)->clone());
+        RegionParts->removeGeometry(0);
+        writePolygon(Part,Value);
+      }
+    }
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void RasterDataset::polygonizeBand(const std::string& FileName, const std::string& FieldName,
+                                   unsigned int RasterBandIndex, unsigned int TileSize, unsigned int ThreadsCount)
+{
+  mp_PolygonizedByRasterBandIndex.insert(
+      std::make_pair(RasterBandIndex,
+                     new openfluid::landr::VectorDataset(FileName)));
+
+  mp_PolygonizedByRasterBandIndex.at(RasterBandIndex)->addALayer("",wkbPolygon);
+  mp_PolygonizedByRasterBandIndex.at(RasterBandIndex)->addAField(FieldName,OFTReal);
+
+  int FieldIndex = mp_PolygonizedByRasterBandIndex.at(RasterBandIndex)->getFieldIndex(FieldName);
+
+  OGRLayer* Layer = mp_PolygonizedByRasterBandIndex.at(RasterBandIndex)->layer(0);
+
+  bool Polygonized = false;
+
+  if (TileSize)
+  {
+    try
+    {
+      polygonizeInTiles(Layer,FieldIndex,RasterBandIndex,TileSize,ThreadsCount);
+      Polygonized = true;
+    }
+    catch (...)
+    {
+      // the partial result is dropped, the original error is kept
+      delete mp_PolygonizedByRasterBandIndex.at(RasterBandIndex);
+      mp_PolygonizedByRasterBandIndex.erase(RasterBandIndex);
+      throw;
+    }
+  }
+  else
+  {
+    Polygonized =
+      (GDALFPolygonize(rasterBand(RasterBandIndex), nullptr, Layer, FieldIndex,nullptr, nullptr, nullptr) == CE_None);
+  }
+
+  if (!Polygonized)
+  {
+    delete mp_PolygonizedByRasterBandIndex.at(RasterBandIndex);
+    mp_PolygonizedByRasterBandIndex.erase(RasterBandIndex);
+
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Error while polygonizing raster.");
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+openfluid::landr::VectorDataset* RasterDataset::polygonize(const std::string& FileName,
+                                                           std::string FieldName,
+                                                           unsigned int RasterBandIndex,
+                                                           unsigned int TileSize,
+                                                           unsigned int ThreadsCount)
+{
+  if (!mp_PolygonizedByRasterBandIndex.count(RasterBandIndex))
+  {
+    FieldName = (FieldName == "" ? getDefaultPolygonizedFieldName() : FieldName);
+
+    if (m_PolygonizedCachePath.empty())
+    {
+      polygonizeBand(FileName,FieldName,RasterBandIndex,TileSize,ThreadsCount);
+      return mp_PolygonizedByRasterBandIndex.at(RasterBandIndex);
+    }
+
+    VSIMkdir(m_PolygonizedCachePath.c_str(),0755);
+
+    const std::string EntryPath = CPLFormFilename(m_PolygonizedCachePath.c_str(),
+                                                  (computeContentHash(RasterBandIndex) + "_" + FieldName).c_str(),
+                                                  nullptr);
+
+    // only one process polygonizes a given raster, the others wait for its entry
+    // as long as it is alive, then take over its lock
+    PolygonizedCacheLock Lock(EntryPath + ".lock");
+
+    while (!loadCachedPolygonized(EntryPath,FileName,FieldName,RasterBandIndex))
+    {
+      if (Lock.isOwner())
+      {
+        break;
+      }
+
+      if (Lock.tryAcquire())
+      {
+        // the entry may have been published between the lookup and the lock, so it is looked up again
+        continue;
+      }
+
+      CPLSleep(0.2);
+    }
+
+    if (!mp_PolygonizedByRasterBandIndex.count(RasterBandIndex))
+    {
+      polygonizeBand(FileName,FieldName,RasterBandIndex,TileSize,ThreadsCount);
+
+      // a failure to write the cache entry does not fail the polygonization
+      try
+      {
+        storeCachedPolygonized(EntryPath,RasterBandIndex);
+      }
+      catch (openfluid::base::FrameworkException&)
+      {
+
+      }
+    }
+  }
+
+  return mp_PolygonizedByRasterBandIndex.at(RasterBandIndex);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::string RasterDataset::getDefaultPolygonizedFieldName()
+{
+  return "PixelVal";
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+OGREnvelope RasterDataset::envelope()
+{
+  if (!mp_GeoTransform)
+  {
+    try
+    {
+      computeGeoTransform();
+    }
+    catch (openfluid::base::FrameworkException&)
+    {
+      // no georeferencing, the envelope is left empty
+    }
   }
 
-  return Envelope;
+  return m_Envelope;
 }
 
 
@@ -43,16 +43,26 @@
 
 
 #include <map>
+#include <string>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <functional>
+#include <memory>
 
 #include <gdal_priv.h>
 #include <ogrsf_frmts.h>
 #include <cpl_conv.h> // for CPLMalloc()
 
+#include <openfluid/base/FrameworkException.hpp>
 #include <openfluid/dllexport.hpp>
 
 
 namespace geos { namespace geom {
 class Coordinate;
+class Envelope;
+class Geometry;
 } }
 
 
@@ -95,8 +105,435 @@ class OPENFLUID_API RasterDataset
     */
     void computeGeoTransform();
 
+    /**
+      @brief A tile of pixel values, converted to float, kept in the cache of this RasterDataset.
+    */
+    struct CacheTile
+    {
+      std::vector<float> Values;
+
+      int XSize;
+
+      int YSize;
+
+      std::list<std::uint64_t>::iterator LRUPosition;
+    };
+
+    /**
+      @brief The cached tiles, indexed by a key built from the raster band index and the tile position.
+    */
+    std::unordered_map<std::uint64_t, CacheTile> m_TilesCache;
+
+    /**
+      @brief The keys of the cached tiles, from the most to the least recently used.
+    */
+    std::list<std::uint64_t> m_TilesLRU;
+
+    /**
+      @brief The maximum memory size of the cached tiles and column strip, in bytes.
+    */
+    std::size_t m_CacheMemoryBudget;
+
+    /**
+      @brief The current memory size of the cached tiles and column strip, in bytes.
+    */
+    std::size_t m_CacheMemoryUsage;
+
+    /**
+      @brief The size of the cached tiles, aligned on the blocks of the raster bands, 0 until first use.
+    */
+    int m_TileXSize;
+
+    int m_TileYSize;
+
+    /**
+      @brief Computes the size of the cached tiles from the block size of the first raster band.
+    */
+    void computeTileSize();
+
+    /**
+      @brief Returns the cached tile at TileX,TileY of a raster band, reading it from the raster if not cached.
+      @details The returned reference is valid until the next call.
+      @throw openfluid::base::FrameworkException if the tile can not be read.
+    */
+    const CacheTile& getTile(unsigned int RasterBandIndex, int TileX, int TileY);
+
+    /**
+      @brief A raster band loaded in memory, as a contiguous buffer of lines.
+    */
+    struct InMemoryBand
+    {
+      GDALDataType DataType;
+
+      int XSize;
+
+      int YSize;
+
+      std::vector<unsigned char> Data;
+    };
+
+    /**
+      @brief The raster bands loaded in memory, shared with the copies of this RasterDataset as they are read-only.
+    */
+    std::map<unsigned int, std::shared_ptr<const InMemoryBand>> m_InMemoryBands;
+
+    /**
+      @brief Returns the buffer of an in-memory raster band.
+      @throw openfluid::base::FrameworkException if the band is not loaded in memory with the DataType pixel type.
+    */
+    const void* inMemoryData(unsigned int RasterBandIndex, GDALDataType DataType) const;
+
+    static GDALDataType dataTypeOf(const float*)
+    {
+      return GDT_Float32;
+    }
+
+    static GDALDataType dataTypeOf(const double*)
+    {
+      return GDT_Float64;
+    }
+
+    static GDALDataType dataTypeOf(const std::int16_t*)
+    {
+      return GDT_Int16;
+    }
+
+    /**
+      @brief A direct access to the pixels of a raster band, loaded or mapped in memory.
+    */
+    struct DirectPixels
+    {
+      const unsigned char* Data;
+
+      GDALDataType DataType;
+
+      int PixelSpace;
+
+      GIntBig LineSpace;
+    };
+
+    /**
+      @brief A raster band of the source file mapped in memory, through its own read-only dataset.
+    */
+    struct MappedBand
+    {
+      GDALDatasetH Dataset;
+
+      CPLVirtualMem* Mem;
+
+      DirectPixels Pixels;
+
+      ~MappedBand();
+    };
+
+    /**
+      @brief The path of the source file of this RasterDataset, empty if unknown.
+    */
+    std::string m_SourcePath;
+
+    bool m_MemoryMappingEnabled;
+
+    /**
+      @brief The mapped raster bands, shared with the copies of this RasterDataset.
+      A null mapping means that the band can not be mapped.
+    */
+    std::map<unsigned int, std::shared_ptr<const MappedBand>> m_MappedBands;
+
+    /**
+      @brief Maps a raster band of the source file in memory.
+      @return The mapped band, or null if the source file is not a raw uncompressed format
+      or if mapping is not available on this platform.
+    */
+    std::shared_ptr<const MappedBand> mapBand(unsigned int RasterBandIndex);
+
+    /**
+      @brief Gets a direct access to the pixels of a raster band, from its in-memory buffer
+      or else from its memory mapping, trying to map the band on first use.
+      @return false if there is no direct access to the band, which must then be read through GDAL.
+    */
+    bool getDirectPixels(unsigned int RasterBandIndex, DirectPixels& Pixels);
+
+    /**
+      @brief A strip of adjacent columns of a raster band, stored column after column.
+    */
+    struct ColumnStrip
+    {
+      unsigned int RasterBandIndex;
+
+      int FirstCol;
+
+      int Width;
+
+      std::vector<float> Values;
+    };
+
+    /**
+      @brief The last column strip read by getValuesOfColumn(), empty until first use.
+    */
+    ColumnStrip m_ColumnStrip;
+
+    /**
+      @brief Frees the column strip and removes it from the cache memory usage.
+    */
+    void releaseColumnStrip();
+
+    /**
+      @brief Evicts the least recently used tiles while the cache memory usage is over the budget,
+      keeping at least KeptTilesCount tiles.
+    */
+    void evictCacheTiles(std::size_t KeptTilesCount);
+
+    /**
+      @brief Gets the values of many pixels, inside the raster, reading each needed cached tile once.
+    */
+    void getValuesOfPixels(const int* Cols, const int* Lines, std::size_t Count, float* Values,
+                           unsigned int RasterBandIndex);
+
+    /**
+      @brief Reads a window of a raster band as float values. All the reads of the raster go through this method.
+      @details The window is copied from the in-memory buffer if the band is loaded in memory,
+      or from the memory mapping of the source file if available.
+      @return The GDAL error code of the read.
+    */
+    CPLErr readRasterWindow(unsigned int RasterBandIndex, int XOffset, int YOffset, int XSize, int YSize,
+                            float* Buffer);
+
+    /**
+      @brief Reads the same window of several raster bands as pixel-interleaved float values,
+      with a single read of the dataset.
+      @details The value of the band at rank b of the pixel (Col,Line) of the window
+      is at Buffer[(Line*XSize+Col)*RasterBandIndexes.size()+b].
+      @return The GDAL error code of the read.
+    */
+    CPLErr readRasterWindow(const std::vector<unsigned int>& RasterBandIndexes,
+                            int XOffset, int YOffset, int XSize, int YSize, float* Buffer);
+
+    /**
+      @brief The content hashes of the raster bands, computed on first use.
+    */
+    std::map<unsigned int, std::string> m_ContentHashes;
+
+    /**
+      @brief The directory of the on-disk cache of polygonized rasters, empty if the cache is disabled.
+    */
+    static std::string m_PolygonizedCachePath;
+
+    /**
+      @brief The age in seconds after which a lock of the polygonized cache is known as left by a dead process.
+    */
+    static double m_PolygonizedCacheLockTimeout;
+
+    class PolygonizedCacheLock;
+
+    /**
+      @brief Polygonizes a raster band into a new VectorDataset, without using the on-disk cache.
+    */
+    void polygonizeBand(const std::string& FileName, const std::string& FieldName, unsigned int RasterBandIndex,
+                        unsigned int TileSize, unsigned int ThreadsCount);
+
+    /**
+      @brief Polygonizes a raster band into Layer, tile by tile on worker threads.
+      @details Each tile is polygonized in the pixel coordinates of the whole raster. The polygons
+      of the same value sharing a boundary segment on a tile seam are then dissolved into a single polygon,
+      so that the result is topologically equivalent to the polygonization of the whole band.
+      @throw openfluid::base::FrameworkException if a tile can not be polygonized.
+    */
+    void polygonizeInTiles(OGRLayer* Layer, int FieldIndex, unsigned int RasterBandIndex,
+                           unsigned int TileSize, unsigned int ThreadsCount);
+
+    /**
+      @brief Loads a polygonized raster band from an entry of the on-disk cache.
+      @return false if the entry does not exist or can not be read.
+    */
+    bool loadCachedPolygonized(const std::string& EntryPath, const std::string& FileName,
+                               const std::string& FieldName, unsigned int RasterBandIndex);
+
+    /**
+      @brief Writes the polygonized raster band as a new entry of the on-disk cache.
+      @throw openfluid::base::FrameworkException if the entry can not be written.
+    */
+    void storeCachedPolygonized(const std::string& EntryPath, unsigned int RasterBandIndex);
+
+    /**
+      @brief The datasets of the overview levels of the source file, opened on first use.
+    */
+    std::map<unsigned int, std::unique_ptr<RasterDataset>> m_Overviews;
+
+    /**
+      @brief The widths in pixels of the overview levels of the source file, finest first.
+    */
+    std::vector<int> m_OverviewsXSizes;
+
+    /**
+      @brief True once m_OverviewsXSizes has been read from the source file.
+    */
+    bool m_OverviewsXSizesLoaded;
+
+    /**
+      @brief Creates a RasterDataset reading an already opened GDALDataset, which is then owned by the RasterDataset.
+    */
+    RasterDataset(GDALDataset* Dataset);
+
+    /**
+      @brief Returns the widths in pixels of the overview levels of the source file, reading them on first use.
+    */
+    const std::vector<int>& overviewsXSizes();
+
+    /**
+      @brief The extent of this RasterDataset, computed with its affine transformation coefficients.
+    */
+    OGREnvelope m_Envelope;
+
+    /**
+      @brief True if the coordinates outside of the raster extent give NaN values instead of an exception.
+    */
+    bool m_OutOfExtentAsNaN;
+
+    /**
+      @brief True if the nodata pixels give NaN values.
+    */
+    bool m_NoDataAsNaN;
+
+    /**
+      @brief The nodata values of the raster bands, with their existence, read on first use.
+    */
+    std::map<unsigned int, std::pair<int, float>> m_NoDataValues;
+
+    /**
+      @brief Gets the nodata value of a raster band.
+      @return false if the raster band has no nodata value.
+    */
+    bool getNoDataValue(unsigned int RasterBandIndex, float& NoData);
+
+    /**
+      @brief Replaces the nodata values of a buffer of a raster band by NaN, if the nodata values are masked.
+    */
+    void maskNoData(unsigned int RasterBandIndex, float* Values, std::size_t Count);
+
   public:
 
+    /**
+      @brief The methods of interpolation of the raster values between the pixel centers.
+    */
+    enum InterpolationMethod { NEAREST, BILINEAR, BICUBIC };
+
+    /**
+      @brief The ways of handling the coordinates and pixels outside of the raster extent.
+    */
+    enum OutOfExtentPolicy { OUT_OF_EXTENT_THROW, OUT_OF_EXTENT_NAN };
+
+    /**
+      @brief The ways of handling the nodata pixels.
+    */
+    enum NoDataPolicy { NODATA_KEEP, NODATA_NAN };
+
+    /**
+      @brief The pixel types of the raster bands loaded in memory.
+    */
+    enum BufferType { FLOAT32, FLOAT64, INT16 };
+
+    /**
+      @brief A read-only view on a line or a column of a raster band loaded in memory, without copy.
+      @details The view is valid as long as the band stays loaded in memory.
+    */
+    template<typename T>
+    class BandView
+    {
+      private:
+
+        const T* mp_Data;
+
+        std::size_t m_Size;
+
+        std::size_t m_Stride;
+
+      public:
+
+        BandView(const T* Data, std::size_t Size, std::size_t Stride) :
+          mp_Data(Data), m_Size(Size), m_Stride(Stride)
+        { }
+
+        std::size_t size() const
+        {
+          return m_Size;
+        }
+
+        /**
+          @brief Returns the value at Index, without bounds checking.
+        */
+        const T& operator[](std::size_t Index) const
+        {
+          return mp_Data[Index * m_Stride];
+        }
+
+        /**
+          @brief Returns the value at Index.
+          @throw openfluid::base::FrameworkException if Index is out of the view.
+        */
+        const T& at(std::size_t Index) const
+        {
+          if (Index >= m_Size)
+          {
+            throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Index out of the raster band view");
+          }
+
+          return mp_Data[Index * m_Stride];
+        }
+    };
+
+    /**
+      @brief Statistics of the pixel values covered by a zone, each pixel being weighted by its covered fraction.
+      @details NaN and nodata pixels are ignored. When no valid pixel is covered, Count is 0
+      and the other statistics are NaN, except Sum and CoveredArea which are 0.
+    */
+    struct ZonalStatistics
+    {
+      enum Statistic { MEAN, MIN, MAX, SUM, COUNT, STDDEV };
+
+      double Mean;
+
+      double Min;
+
+      double Max;
+
+      /**
+        @brief The sum of the pixel values, weighted by their covered fractions.
+      */
+      double Sum;
+
+      /**
+        @brief The sum of the covered fractions of the valid pixels.
+      */
+      double Count;
+
+      /**
+        @brief The weighted population standard deviation of the pixel values.
+      */
+      double StdDev;
+
+      /**
+        @brief The area of the zone over the valid pixels.
+      */
+      double CoveredArea;
+
+      ZonalStatistics();
+
+      double get(Statistic Stat) const;
+    };
+
+    /**
+      @brief A function called for each pixel covered by a zone, with its column and line indexes,
+      its value and its covered fraction in ]0,1].
+    */
+    typedef std::function<void(int ColIndex, int LineIndex, float Value, double Coverage)> ZonePixelVisitor_t;
+
+    /**
+      @brief A function called for each pixel covered by a zone, with its column and line indexes,
+      its values in the order of the visited bands and its covered fraction in ]0,1].
+    */
+    typedef std::function<void(int ColIndex, int LineIndex, const float* Values, double Coverage)>
+      MultiBandZonePixelVisitor_t;
+
     /**
       @brief Create a virtual (in memory) copy of Value GDALDataset
       @param Value The GeoRasterValue to copy
@@ -134,13 +571,14 @@ class OPENFLUID_API RasterDataset
 
     /**
       @brief Returns the column and line index of a pixel from the coordinate of the pixel.
+      @details The indexes are rounded down, so that a coordinate before the origin gives a negative index.
       @param Coo A geos::geom::Coordinate.
       @return A pair of the column and line index of the pixel in this RasterDataset.
     */
     std::pair<int, int> getPixelFromCoordinate(geos::geom::Coordinate Coo);
 
     /**
-      @brief Returns the geos::geom::Coordinate origin of this RasterDataset.
+      @brief Returns a new geos::geom::Coordinate origin of this RasterDataset, to be deleted by the caller.
     */
     geos::geom::Coordinate* computeOrigin();
 
@@ -171,12 +609,208 @@ class OPENFLUID_API RasterDataset
     std::vector<float> getValuesOfColumn(int ColIndex,
                                          unsigned int RasterBandIndex = 1);
 
+    /**
+      @brief Fills a caller buffer with the pixel values of a line of this RasterDataset, without allocation.
+      @param LineIndex The line index to get the pixel values.
+      @param Values The buffer to fill, of the raster width.
+      @param RasterBandIndex The raster band index (default is 1).
+      @throw openfluid::base::FrameworkException if the line is outside of the raster.
+    */
+    void getValuesOfLine(int LineIndex, float* Values, unsigned int RasterBandIndex = 1);
+
+    /**
+      @brief Fills a caller buffer with the pixel values of a column of this RasterDataset.
+      @details Unless the band is loaded or mapped in memory, a strip of adjacent columns, aligned on the
+      raster blocks, is read line-wise once and kept transposed, so that sweeping the columns
+      of a raster does not read it column by column. The strip is counted in the cache memory budget,
+      and is split into narrower strips aligned in the block if the block columns exceed it.
+      @param ColIndex The column index to get the pixel values.
+      @param Values The buffer to fill, of the raster height.
+      @param RasterBandIndex The raster band index (default is 1).
+      @throw openfluid::base::FrameworkException if the column is outside of the raster.
+    */
+    void getValuesOfColumn(int ColIndex, float* Values, unsigned int RasterBandIndex = 1);
+
+    /**
+      @brief Sets the maximum memory size of the tiles cache used by pixel and coordinate lookups.
+      @details The cache keeps the most recently used tiles, aligned on the blocks of the raster bands.
+      Default is 64 MB. At least one tile is always kept.
+      @param Bytes The memory budget, in bytes.
+    */
+    void setCacheMemoryBudget(std::size_t Bytes);
+
+    /**
+      @brief Returns the maximum memory size of the tiles cache, in bytes.
+    */
+    std::size_t getCacheMemoryBudget() const
+    {
+      return m_CacheMemoryBudget;
+    }
+
+    /**
+      @brief Removes all the tiles and the column strip from the cache.
+    */
+    void clearCache();
+
+    /**
+      @brief Loads a raster band in memory, as a contiguous buffer of Type pixels read at once.
+      @details Once loaded, all the pixel reads of the band, including sampling and zonal statistics,
+      are served from the buffer. The values are converted to Type by GDAL, so that loading a float raster
+      as INT16 rounds its values to the nearest integer, clamped to the INT16 range. The buffer is shared with the copies of this RasterDataset.
+      @param RasterBandIndex The raster band index (default is 1).
+      @param Type The pixel type of the buffer (default is FLOAT32).
+      @throw openfluid::base::FrameworkException if the band can not be read.
+    */
+    void loadInMemory(unsigned int RasterBandIndex = 1, BufferType Type = FLOAT32);
+
+    /**
+      @brief Releases the in-memory buffer of a raster band, reads go back to the raster.
+      @param RasterBandIndex The raster band index (default is 1).
+    */
+    void unloadFromMemory(unsigned int RasterBandIndex = 1);
+
+    /**
+      @brief Returns true if the raster band is loaded in memory.
+      @param RasterBandIndex The raster band index (default is 1).
+    */
+    bool isLoadedInMemory(unsigned int RasterBandIndex = 1) const;
+
+    /**
+      @brief Returns the contiguous buffer of a raster band loaded in memory, line after line.
+      @details T must match the BufferType of the loaded band: float, double or std::int16_t.
+      @param RasterBandIndex The raster band index (default is 1).
+      @throw openfluid::base::FrameworkException if the band is not loaded in memory as T pixels.
+    */
+    template<typename T>
+    const T* inMemoryBuffer(unsigned int RasterBandIndex = 1) const
+    {
+      return static_cast<const T*>(inMemoryData(RasterBandIndex, dataTypeOf(static_cast<const T*>(nullptr))));
+    }
+
+    /**
+      @brief Returns the value of a pixel of a raster band loaded in memory, without bounds checking.
+      @throw openfluid::base::FrameworkException if the band is not loaded in memory as T pixels.
+    */
+    template<typename T>
+    const T& inMemoryPixel(int ColIndex, int LineIndex, unsigned int RasterBandIndex = 1) const
+    {
+      return inMemoryBuffer<T>(RasterBandIndex)[std::size_t(LineIndex) * mp_Dataset->GetRasterXSize() + ColIndex];
+    }
+
+    /**
+      @brief Returns the value of a pixel of a raster band loaded in memory.
+      @throw openfluid::base::FrameworkException if the band is not loaded in memory as T pixels,
+      or if the pixel is outside of the raster.
+    */
+    template<typename T>
+    const T& inMemoryPixelAt(int ColIndex, int LineIndex, unsigned int RasterBandIndex = 1) const
+    {
+      if (ColIndex < 0 || LineIndex < 0 ||
+          ColIndex >= mp_Dataset->GetRasterXSize() || LineIndex >= mp_Dataset->GetRasterYSize())
+      {
+        throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+      }
+
+      return inMemoryPixel<T>(ColIndex, LineIndex, RasterBandIndex);
+    }
+
+    /**
+      @brief Returns a view on a line of a raster band loaded in memory.
+      @throw openfluid::base::FrameworkException if the band is not loaded in memory as T pixels,
+      or if the line is outside of the raster.
+    */
+    template<typename T>
+    BandView<T> lineView(int LineIndex, unsigned int RasterBandIndex = 1) const
+    {
+      const T* Data = inMemoryBuffer<T>(RasterBandIndex);
+
+      if (LineIndex < 0 || LineIndex >= mp_Dataset->GetRasterYSize())
+      {
+        throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+      }
+
+      return BandView<T>(Data + std::size_t(LineIndex) * mp_Dataset->GetRasterXSize(),
+                         mp_Dataset->GetRasterXSize(), 1);
+    }
+
+    /**
+      @brief Returns a view on a column of a raster band loaded in memory.
+      @throw openfluid::base::FrameworkException if the band is not loaded in memory as T pixels,
+      or if the column is outside of the raster.
+    */
+    template<typename T>
+    BandView<T> columnView(int ColIndex, unsigned int RasterBandIndex = 1) const
+    {
+      const T* Data = inMemoryBuffer<T>(RasterBandIndex);
+
+      if (ColIndex < 0 || ColIndex >= mp_Dataset->GetRasterXSize())
+      {
+        throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION, "Error while getting value from raster.");
+      }
+
+      return BandView<T>(Data + ColIndex, mp_Dataset->GetRasterYSize(), mp_Dataset->GetRasterXSize());
+    }
+
+    /**
+      @brief Enables or disables the memory mapping of the source file, enabled by default.
+      @details When enabled, the raster bands of uncompressed raw formats (such as untiled GeoTIFF, ENVI or EHdr/BIL)
+      are mapped in memory on first read, so that the pixels are read through the page cache of the system,
+      shared between processes. Other formats are read through GDAL.
+      Bands loaded with loadInMemory() are always read from memory.
+    */
+    void setMemoryMappingEnabled(bool Enabled);
+
+    /**
+      @brief Returns true if the raster band is read through a memory mapping of the source file.
+      @param RasterBandIndex The raster band index (default is 1).
+    */
+    bool isMemoryMapped(unsigned int RasterBandIndex = 1);
+
+    /**
+      @brief Sets how the sampling methods handle the coordinates and pixels outside of the raster extent.
+      @details With OUT_OF_EXTENT_NAN, they give NaN values for them without reading the raster.
+      @param Policy The policy, default is OUT_OF_EXTENT_THROW.
+    */
+    void setOutOfExtentPolicy(OutOfExtentPolicy Policy);
+
+    /**
+      @brief Returns how the sampling methods handle the coordinates and pixels outside of the raster extent.
+    */
+    OutOfExtentPolicy getOutOfExtentPolicy() const;
+
+    /**
+      @brief Sets how the sampling methods handle the nodata pixels.
+      @details With NODATA_NAN, the nodata pixels give NaN values. The nodata pixels of a cached tile
+      are masked once when the tile is read. Zonal statistics and interpolations always leave out the nodata pixels.
+      @param Policy The policy, default is NODATA_KEEP.
+    */
+    void setNoDataPolicy(NoDataPolicy Policy);
+
+    /**
+      @brief Returns how the sampling methods handle the nodata pixels.
+    */
+    NoDataPolicy getNoDataPolicy() const;
+
+    /**
+      @brief Returns true if a coordinate falls in a pixel of the raster, without reading the raster.
+      @param Coo The geos::geom::Coordinate.
+    */
+    bool isInExtent(const geos::geom::Coordinate& Coo);
+
+    /**
+      @brief Returns true if an envelope intersects the raster extent, without reading the raster.
+      @param Env The geos::geom::Envelope.
+    */
+    bool intersectsExtent(const geos::geom::Envelope& Env);
+
     /**
       @brief Returns the pixel value with column and line index.
       @param ColIndex The column index.
       @param LineIndex The line index.
       @param RasterBandIndex The raster band index (default is 1).
-      @return The pixel value.
+      @return The pixel value, NaN for nodata pixels with the NODATA_NAN policy.
+      @throw openfluid::base::FrameworkException if the pixel is outside of the raster,
+      with the OUT_OF_EXTENT_THROW policy.
     */
     float getValueOfPixel(int ColIndex,
                           int LineIndex,
@@ -190,6 +824,179 @@ class OPENFLUID_API RasterDataset
     */
     float getValueOfCoordinate(geos::geom::Coordinate Coo, unsigned int RasterBandIndex = 1);
 
+    /**
+      @brief Gets the pixel values at many coordinates in a single pass over the raster.
+      @details The coordinates are transformed to pixels, sorted by cached tile,
+      and each needed tile is read once, so the cost no longer depends on the order of the coordinates.
+      @param Coords The array of Count geos::geom::Coordinate to sample.
+      @param Count The number of coordinates.
+      @param Values The array of Count values to fill, in the order of Coords.
+      @param RasterBandIndex The raster band index (default is 1).
+      @throw openfluid::base::FrameworkException if a coordinate is outside of the raster,
+      with the OUT_OF_EXTENT_THROW policy.
+    */
+    void getValuesOfCoordinates(const geos::geom::Coordinate* Coords, std::size_t Count, float* Values,
+                                unsigned int RasterBandIndex = 1);
+
+    /**
+      @brief Gets the values interpolated at many coordinates, in a single pass over the raster.
+      @details The pixels of the interpolation kernels of all the coordinates (2x2 for bilinear, 4x4 for bicubic)
+      are fetched at once from the cached tiles. Pixels beyond the raster edges are replaced by the edge pixels.
+      With bilinear interpolation, NaN and nodata pixels are left out and the weights of the other pixels
+      are renormalized, the value is NaN if all the pixels are left out. Bicubic interpolation
+      falls back to bilinear interpolation when its kernel contains NaN or nodata pixels.
+      NEAREST gives the same values as getValuesOfCoordinates().
+      @param Coords The array of Count geos::geom::Coordinate to sample.
+      @param Count The number of coordinates.
+      @param Values The array of Count values to fill, in the order of Coords.
+      @param Method The interpolation method (default is BILINEAR).
+      @param RasterBandIndex The raster band index (default is 1).
+      @throw openfluid::base::FrameworkException if a coordinate is outside of the raster,
+      with the OUT_OF_EXTENT_THROW policy.
+    */
+    void getInterpolatedValuesOfCoordinates(const geos::geom::Coordinate* Coords, std::size_t Count, float* Values,
+                                            InterpolationMethod Method = BILINEAR,
+                                            unsigned int RasterBandIndex = 1);
+
+    /**
+      @brief Visits the pixels covered by a polygonal zone, without polygonizing the raster.
+      @details The zone is scanned line by line over the pixel grid and only the raster lines
+      crossed by the zone are read. A pixel is covered when its center is inside the zone.
+      With exact coverage, the pixels crossed by the zone boundary are clipped to the zone
+      and visited with their covered fraction, so that the result equals an area-weighted overlay.
+      @param Zone A geos::geom::Polygon or geos::geom::MultiPolygon, in the raster coordinate system.
+      @param Visitor The function called for each covered pixel, line by line.
+      @param ExactCoverage If true, computes the partial coverage of the boundary pixels (default is true).
+      @param RasterBandIndex The raster band index (default is 1).
+      @throw openfluid::base::FrameworkException if the zone is not polygonal or the raster can not be read.
+    */
+    void visitZonePixels(const geos::geom::Geometry* Zone, const ZonePixelVisitor_t& Visitor,
+                         bool ExactCoverage = true, unsigned int RasterBandIndex = 1);
+
+    /**
+      @brief Visits the pixels covered by a polygonal zone for several raster bands at once.
+      @details Same as the single band visitZonePixels(), but the values of all the bands
+      at a pixel are read together, so the zone geometry is scanned only once.
+      @param Zone A geos::geom::Polygon or geos::geom::MultiPolygon, in the raster coordinate system.
+      @param RasterBandIndexes The raster band indexes to read.
+      @param Visitor The function called for each covered pixel, line by line.
+      @param ExactCoverage If true, computes the partial coverage of the boundary pixels (default is true).
+      @throw openfluid::base::FrameworkException if the zone is not polygonal or the raster can not be read.
+    */
+    void visitZonePixels(const geos::geom::Geometry* Zone, const std::vector<unsigned int>& RasterBandIndexes,
+                         const MultiBandZonePixelVisitor_t& Visitor, bool ExactCoverage = true);
+
+    /**
+      @brief Computes the statistics of the pixel values covered by a polygonal zone.
+      @param Zone A geos::geom::Polygon or geos::geom::MultiPolygon, in the raster coordinate system.
+      @param ExactCoverage If true, the boundary pixels are weighted by their covered fraction (default is true).
+      @param RasterBandIndex The raster band index (default is 1).
+      @throw openfluid::base::FrameworkException if the zone is not polygonal or the raster can not be read.
+    */
+    ZonalStatistics computeZonalStatistics(const geos::geom::Geometry* Zone, bool ExactCoverage = true,
+                                           unsigned int RasterBandIndex = 1);
+
+    /**
+      @brief Computes the statistics of the pixel values covered by a polygonal zone
+      for several raster bands, in a single pass over the zone.
+      @param Zone A geos::geom::Polygon or geos::geom::MultiPolygon, in the raster coordinate system.
+      @param RasterBandIndexes The raster band indexes.
+      @param ExactCoverage If true, the boundary pixels are weighted by their covered fraction (default is true).
+      @return The statistics of each band, in the order of RasterBandIndexes.
+      @throw openfluid::base::FrameworkException if the zone is not polygonal or the raster can not be read.
+    */
+    std::vector<ZonalStatistics> computeZonalStatistics(const geos::geom::Geometry* Zone,
+                                                        const std::vector<unsigned int>& RasterBandIndexes,
+                                                        bool ExactCoverage = true);
+
+    /**
+      @brief Returns the number of overview levels (pyramids) of the source file of this RasterDataset.
+    */
+    unsigned int getOverviewsCount();
+
+    /**
+      @brief Builds the overview levels of the source file of this RasterDataset, by factors of 2.
+      @details The overviews are written aside the source file (.ovr file) and reused by the next runs.
+      With AVERAGE resampling, the zonal means of an overview match the full resolution ones,
+      but the minimums, maximums and standard deviations are smoothed.
+      @param Resampling The GDAL resampling method (default is "AVERAGE").
+      @throw openfluid::base::FrameworkException if the overviews can not be built.
+    */
+    void buildOverviews(const std::string& Resampling = "AVERAGE");
+
+    /**
+      @brief Returns a RasterDataset reading an overview level of the source file of this RasterDataset.
+      @details All the sampling and zonal statistics methods of the returned RasterDataset
+      work at the resolution of the overview. The returned RasterDataset is owned by this RasterDataset,
+      and follows its out-of-extent and nodata policies.
+      @param Level The overview level, 0 for this RasterDataset, 1 for the finest overview.
+      @throw openfluid::base::FrameworkException if the level does not exist or overviews are not supported.
+    */
+    RasterDataset& overview(unsigned int Level);
+
+    /**
+      @brief Selects the coarsest overview level still accurate enough for a zone.
+      @details The pixel side of the selected level is at most Accuracy times the side of a square of area ZoneArea,
+      so that the zone covers at least about 1/Accuracy² pixels. For example, an accuracy of 0.01 keeps
+      about 10000 pixels per zone.
+      @param ZoneArea The area of the zone, in the raster coordinate system.
+      @param Accuracy The requested relative accuracy, 0 for the full resolution.
+      @param BuildMissing If true and the source file has no overview, builds them (default is true).
+      @return The overview level, to be passed to overview().
+    */
+    unsigned int selectOverviewLevel(double ZoneArea, double Accuracy, bool BuildMissing = true);
+
+    /**
+      @brief Runs a task for each index in [0,TasksCount[ on a pool of worker threads, each running task
+      being given a private copy of this RasterDataset.
+      @details GDAL datasets can not be shared between threads, so one copy per thread is made,
+      this RasterDataset being used as the first one. See LandRTools::runInParallel().
+      @param TasksCount The number of tasks.
+      @param Task The function to run for each task index, with the raster it may read.
+      @param ThreadsCount The number of worker threads, 0 (default) for the number of available cores.
+    */
+    void runOnCopies(unsigned int TasksCount,
+                     const std::function<void(unsigned int, RasterDataset&)>& Task,
+                     unsigned int ThreadsCount = 0);
+
+    /**
+      @brief Sets the directory of the on-disk cache of polygonized rasters, shared by all the RasterDataset.
+      @details When set, polygonize() looks for a previous result of the same raster content, band
+      and field name in this directory, written by any run or process, before polygonizing.
+      The concurrent processes polygonizing the same raster wait for the first one instead of duplicating the work.
+      An empty path (default) disables the cache.
+      @param Path The path of the cache directory, created if needed.
+    */
+    static void setPolygonizedCachePath(const std::string& Path);
+
+    /**
+      @brief Returns the directory of the on-disk cache of polygonized rasters, empty if the cache is disabled.
+    */
+    static std::string getPolygonizedCachePath();
+
+    /**
+      @brief Sets the timeout of the locks of the on-disk cache of polygonized rasters.
+      @details The process polygonizing a raster for the cache refreshes its lock while it works, and the
+      other processes wait for its result as long as the lock is refreshed. A lock which has not been refreshed
+      for Seconds is known as left by a dead process: it is broken and taken over. Default is 60 seconds.
+      @param Seconds The timeout, in seconds.
+    */
+    static void setPolygonizedCacheLockTimeout(double Seconds);
+
+    /**
+      @brief Returns the timeout of the locks of the on-disk cache of polygonized rasters, in seconds.
+    */
+    static double getPolygonizedCacheLockTimeout();
+
+    /**
+      @brief Returns a hash of the content of a raster band, as 16 hexadecimal digits.
+      @details The hash covers the raster size, geotransform, data type, nodata value and all the pixel values,
+      so that it does not depend on the file name or format. It is computed once per band.
+      @param RasterBandIndex The raster band index (default is 1).
+      @throw openfluid::base::FrameworkException if the raster can not be read.
+    */
+    std::string computeContentHash(unsigned int RasterBandIndex = 1);
+
     /**
       @brief Creates a new VectorDataset with polygons for all connected regions of pixels
       in the raster sharing a common pixel value.
@@ -199,16 +1006,23 @@ class OPENFLUID_API RasterDataset
       limited to 10 characters (or will be truncated).
       Default is set to "PixelVal". Type of field is OFTReal .
       @param RasterBandIndex The raster band index (default is 1).
-      @return The newly created VectorDataset.
+      @param TileSize If not 0, the band is polygonized by square tiles of TileSize pixels on worker threads,
+      then the polygons are dissolved across the tile seams. The polygons are the same as with
+      the polygonization of the whole band, but in a different order (default is 0).
+      @param ThreadsCount The number of worker threads of the tiled polygonization,
+      0 (default) for the number of available cores
+      @return The newly created VectorDataset, copied from the on-disk cache if enabled and available.
     */
     openfluid::landr::VectorDataset* polygonize(const std::string& FileName,
                                                 std::string FieldName = "",
-                                                unsigned int RasterBandIndex = 1);
+                                                unsigned int RasterBandIndex = 1,
+                                                unsigned int TileSize = 0,
+                                                unsigned int ThreadsCount = 0);
 
     static std::string getDefaultPolygonizedFieldName();
 
     /**
-      @brief Returns the OGREnvelope associated to this RasterDataset.
+      @brief Returns the OGREnvelope associated to this RasterDataset, computed once.
     */
     OGREnvelope envelope();
 
@@ -39,6 +39,11 @@
 
 
 #include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <set>
+#include <unordered_map>
 #include <utility>
 #include <chrono>
 
@@ -52,9 +57,18 @@
 #include <geos/geom/Coordinate.h>
 #include <geos/geom/CoordinateArraySequence.h>
 #include <geos/operation/overlay/snap/GeometrySnapper.h>
+#include <geos/geom/Envelope.h>
+#include <geos/geom/prep/PreparedGeometry.h>
+#include <geos/geom/prep/PreparedGeometryFactory.h>
+#include <geos/geom/IntersectionMatrix.h>
+#include <geos/index/strtree/STRtree.h>
+#include <geos/index/quadtree/Quadtree.h>
+#include <geos/operation/distance/DistanceOp.h>
+#include <geos/operation/valid/TopologyValidationError.h>
 
 #include <openfluid/landr/GEOSHelpers.hpp>
 #include <openfluid/landr/VectorDataset.hpp>
+#include <openfluid/landr/LandRTools.hpp>
 #include <openfluid/base/FrameworkException.hpp>
 #include <openfluid/base/Environment.hpp>
 #include <openfluid/tools/Filesystem.hpp>
@@ -64,7 +78,9 @@
 namespace openfluid { namespace landr {
 
 
-VectorDataset::VectorDataset(const std::string& FileName)
+VectorDataset::VectorDataset(const std::string& FileName) :
+    mp_DataSource(nullptr), mp_WriteLayer(nullptr), m_WriteBatchSize(0), m_WrittenInBatch(0),
+    m_IsDatasetTransaction(false)
 {
   std::string DefaultDriverName = "ESRI Shapefile";
 
@@ -133,61 +149,69 @@ VectorDataset::VectorDataset(const std::string& FileName)
 // =====================================================================
 
 
-VectorDataset::VectorDataset(openfluid::core::GeoVectorValue& Value)
+VectorDataset::VectorDataset(openfluid::core::GeoVectorValue& Value) :
+    mp_DataSource(nullptr), mp_WriteLayer(nullptr), m_WriteBatchSize(0), m_WrittenInBatch(0),
+    m_IsDatasetTransaction(false)
 {
-#if (GDAL_VERSION_MAJOR >= 2)
-  GDALAllRegister();
-#else
-  OGRRegisterAll();
-#endif
-
   GDALDataset_COMPAT* DS = Value.data();
-  GDALDriver_COMPAT* Driver = DS->GetDriver();
-
-#if (GDAL_VERSION_MAJOR >= 2)
-  std::string DriverName = Driver->GetDescription();
-#else
-  std::string DriverName = Driver->GetName();
-#endif
 
-  if (DriverName!="ESRI Shapefile")
+  copySource(DS,[DS](GDALDriver_COMPAT* Driver, const std::string& Path) -> GDALDataset_COMPAT*
   {
-    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-                                              "\"" + DriverName + "\" driver not supported.");
-  }
+    return GDALCopy_COMPAT(Driver,DS,Path.c_str());
+  });
+}
 
-#if (GDAL_VERSION_MAJOR >= 2)
-  std::string Path = getTimestampedPath(openfluid::tools::Filesystem::basename(DS->GetDescription()));
-#else
-  std::string Path = getTimestampedPath(openfluid::tools::Filesystem::basename(DS->GetName()));
-#endif
 
-  mp_DataSource = GDALCopy_COMPAT(Driver,DS,Path.c_str());
+// =====================================================================
+// =====================================================================
+
 
-  if (!mp_DataSource)
+VectorDataset::VectorDataset(const VectorDataset& Other) :
+    mp_DataSource(nullptr), mp_WriteLayer(nullptr), m_WriteBatchSize(0), m_WrittenInBatch(0),
+    m_IsDatasetTransaction(false)
+{
+  GDALDataset_COMPAT* DS = Other.source();
+
+  copySource(DS,[DS](GDALDriver_COMPAT* Driver, const std::string& Path) -> GDALDataset_COMPAT*
   {
-    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-                                              "Error while creating " + Path + " : " +
-                                              "Creation of data source failed.");
-  }
+    return GDALCopy_COMPAT(Driver,DS,Path.c_str());
+  });
+}
 
-#if (GDAL_VERSION_MAJOR >= 2)
 
-#else
-  mp_DataSource->SetDriver(Driver);
-#endif
+// =====================================================================
+// =====================================================================
 
 
-  // necessary to ensure headers are written out in an orderly way and all resources are recovered
-  GDALClose_COMPAT(mp_DataSource);
-  mp_DataSource = GDALOpenRW_COMPAT(Path.c_str());
+VectorDataset::VectorDataset(openfluid::core::GeoVectorValue& Value, const OGREnvelope& Extent,
+                             const std::string& AttributeFilter) :
+    mp_DataSource(nullptr), mp_WriteLayer(nullptr), m_WriteBatchSize(0), m_WrittenInBatch(0),
+    m_IsDatasetTransaction(false)
+{
+  OGRLinearRing Ring;
+  Ring.addPoint(Extent.MinX,Extent.MinY);
+  Ring.addPoint(Extent.MaxX,Extent.MinY);
+  Ring.addPoint(Extent.MaxX,Extent.MaxY);
+  Ring.addPoint(Extent.MinX,Extent.MaxY);
+  Ring.closeRings();
 
-  if (!mp_DataSource)
-  {
-    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-                                              "Error while opening " + Path + " : " +
-                                              "Loading of data source failed.");
-  }
+  OGRPolygon ExtentPolygon;
+  ExtentPolygon.addRing(&Ring);
+
+  copyFilteredSource(Value.data(),&ExtentPolygon,AttributeFilter);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+VectorDataset::VectorDataset(openfluid::core::GeoVectorValue& Value, OGRGeometry* Clip,
+                             const std::string& AttributeFilter) :
+    mp_DataSource(nullptr), mp_WriteLayer(nullptr), m_WriteBatchSize(0), m_WrittenInBatch(0),
+    m_IsDatasetTransaction(false)
+{
+  copyFilteredSource(Value.data(),Clip,AttributeFilter);
 }
 
 
@@ -195,7 +219,8 @@ VectorDataset::VectorDataset(openfluid::core::GeoVectorValue& Value)
 // =====================================================================
 
 
-VectorDataset::VectorDataset(const VectorDataset& Other)
+void VectorDataset::copySource(GDALDataset_COMPAT* DS,
+                               const std::function<GDALDataset_COMPAT*(GDALDriver_COMPAT*,const std::string&)>& Copy)
 {
 #if (GDAL_VERSION_MAJOR >= 2)
   GDALAllRegister();
@@ -203,7 +228,6 @@ VectorDataset::VectorDataset(const VectorDataset& Other)
   OGRRegisterAll();
 #endif
 
-  GDALDataset_COMPAT* DS = Other.source();
   GDALDriver_COMPAT* Driver = DS->GetDriver();
 
 #if (GDAL_VERSION_MAJOR >= 2)
@@ -224,7 +248,7 @@ VectorDataset::VectorDataset(const VectorDataset& Other)
   std::string Path = getTimestampedPath(openfluid::tools::Filesystem::basename(DS->GetName()));
 #endif
 
-  mp_DataSource = GDALCopy_COMPAT(Driver,DS,Path.c_str());
+  mp_DataSource = Copy(Driver,Path);
 
   if (!mp_DataSource)
   {
@@ -257,6 +281,73 @@ VectorDataset::VectorDataset(const VectorDataset& Other)
 // =====================================================================
 
 
+void VectorDataset::copyFilteredSource(GDALDataset_COMPAT* DS, OGRGeometry* Clip, const std::string& AttributeFilter)
+{
+  // the source is shared with its GeoVectorValue, its filters must be removed whatever happens
+  auto clearFilters = [DS]()
+  {
+    for (int i = 0; i < DS->GetLayerCount(); i++)
+    {
+      DS->GetLayer(i)->SetSpatialFilter(nullptr);
+      DS->GetLayer(i)->SetAttributeFilter(nullptr);
+    }
+  };
+
+  copySource(DS,[&](GDALDriver_COMPAT* Driver, const std::string& Path) -> GDALDataset_COMPAT*
+  {
+    // the filters are applied by the driver while reading, so that filtered out features are not decoded
+    for (int i = 0; i < DS->GetLayerCount(); i++)
+    {
+      OGRLayer* Layer = DS->GetLayer(i);
+
+      Layer->SetSpatialFilter(Clip);
+
+      if (Layer->SetAttributeFilter(AttributeFilter.empty() ? nullptr : AttributeFilter.c_str()) != OGRERR_NONE)
+      {
+        clearFilters();
+        throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                                  "Wrong attribute filter \"" + AttributeFilter + "\"");
+      }
+    }
+
+    GDALDataset_COMPAT* Copied = GDALCreate_COMPAT(Driver,Path.c_str());
+
+    if (!Copied)
+    {
+      clearFilters();
+      return nullptr;
+    }
+
+    for (int i = 0; i < DS->GetLayerCount(); i++)
+    {
+      OGRLayer* Layer = DS->GetLayer(i);
+
+      if (!Copied->CopyLayer(Layer,Layer->GetName()))
+      {
+        std::string LayerName = Layer->GetName();
+
+        // the destructor is not called when the constructor throws, the partial copy is removed here
+        clearFilters();
+        GDALClose_COMPAT(Copied);
+        GDALDelete_COMPAT(Driver,Path.c_str());
+
+        throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                                  "Error while creating " + Path + " : " +
+                                                  "Copy of layer " + LayerName + " failed.");
+      }
+    }
+
+    clearFilters();
+
+    return Copied;
+  });
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 std::string VectorDataset::getTimestampedPath(const std::string& OriginalFileName)
 {
   std::string FileWOExt = openfluid::tools::Filesystem::basename(OriginalFileName);
@@ -317,6 +408,19 @@ bool VectorDataset::isAlreadyExisting(const std::string& Path)
 
 VectorDataset::~VectorDataset()
 {
+  // pending features of an unfinished write session are discarded
+  if (mp_WriteLayer)
+  {
+    try
+    {
+      rollbackWriteSession();
+    }
+    catch (openfluid::base::FrameworkException&)
+    {
+      mp_WriteLayer = nullptr;
+    }
+  }
+
   GDALDriver_COMPAT* Driver = mp_DataSource->GetDriver();
 
 #if (GDAL_VERSION_MAJOR >= 2)
@@ -339,19 +443,21 @@ VectorDataset::~VectorDataset()
 // =====================================================================
 
 
-GDALDataset_COMPAT* VectorDataset::source()
+void VectorDataset::startWriteTransaction()
 {
-  return mp_DataSource;
-}
-
+  m_IsDatasetTransaction = false;
 
-// =======================================y==============================
-// =====================================================================
+#if (GDAL_VERSION_MAJOR >= 2)
+  m_IsDatasetTransaction = (mp_DataSource->StartTransaction() == OGRERR_NONE);
+#endif
 
+  // drivers without dataset transactions may still support (or ignore) layer transactions
+  if (!m_IsDatasetTransaction && mp_WriteLayer->StartTransaction() != OGRERR_NONE)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Unable to start a write transaction");
+  }
 
-GDALDataset_COMPAT* VectorDataset::source() const
-{
-  return mp_DataSource;
+  m_WrittenInBatch = 0;
 }
 
 
@@ -359,51 +465,27 @@ GDALDataset_COMPAT* VectorDataset::source() const
 // =====================================================================
 
 
-void VectorDataset::copyToDisk(const std::string& FilePath,
-                               const std::string& FileName,
-                               bool ReplaceIfExists)
+void VectorDataset::commitWriteTransaction()
 {
-  GDALDriver_COMPAT* Driver = mp_DataSource->GetDriver();
+  OGRErr Err;
 
-  if (!openfluid::tools::Filesystem::isDirectory(FilePath))
+#if (GDAL_VERSION_MAJOR >= 2)
+  if (m_IsDatasetTransaction)
   {
-    openfluid::tools::Filesystem::makeDirectory(FilePath);
+    Err = mp_DataSource->CommitTransaction();
   }
-
-  std::string Path = openfluid::core::GeoValue::computeAbsolutePath(FilePath,
-                                                                    FileName);
-
-  GDALDataset_COMPAT* DS = GDALOpenRO_COMPAT(Path.c_str());
-
-  if (DS)
+  else
+#endif
   {
-    if (ReplaceIfExists)
-    {
-      GDALDriver_COMPAT* Driver = DS->GetDriver();
-      GDALClose_COMPAT(DS);
-      GDALDelete_COMPAT(Driver,Path.c_str());
-    }
-    else
-    {
-      GDALClose_COMPAT(DS);
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-                                                "Error while creating " + Path +
-                                                " : This VectorDataset already exists.");
-    }
+    Err = mp_WriteLayer->CommitTransaction();
   }
 
-  GDALDataset_COMPAT* NewDS = nullptr;
-
-  NewDS = GDALCopy_COMPAT(Driver,mp_DataSource,Path.c_str());
+  m_WrittenInBatch = 0;
 
-  if (!NewDS)
+  if (Err != OGRERR_NONE)
   {
-    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-                                              "Error while creating " + Path + " : Copying of OGRDataSource failed.");
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Unable to commit the written features");
   }
-
-  // necessary to ensure headers are written out in an orderly way and all resources are recovered
-  GDALClose_COMPAT(NewDS);
 }
 
 
@@ -411,43 +493,60 @@ void VectorDataset::copyToDisk(const std::string& FilePath,
 // =====================================================================
 
 
-void VectorDataset::addALayer(std::string LayerName,
-                              OGRwkbGeometryType LayerType,
-                              OGRSpatialReference* SpatialRef)
+void VectorDataset::rollbackWriteTransaction()
 {
+  OGRErr Err;
+
 #if (GDAL_VERSION_MAJOR >= 2)
-  std::string Path = mp_DataSource->GetDescription();
-#else
-  std::string Path = mp_DataSource->GetName();
+  if (m_IsDatasetTransaction)
+  {
+    Err = mp_DataSource->RollbackTransaction();
+  }
+  else
 #endif
+  {
+    Err = mp_WriteLayer->RollbackTransaction();
+  }
 
+  m_WrittenInBatch = 0;
 
-  if (mp_DataSource->GetLayerByName(LayerName.c_str()) != nullptr)
+  if (Err != OGRERR_NONE)
   {
-    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-                                              "Error while adding a layer to " + Path +
-                                              ": a layer named " + LayerName + " already exists.");
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"Unable to roll back the written features");
   }
+}
 
-  OGRLayer* Layer = mp_DataSource->CreateLayer(LayerName.c_str(), SpatialRef,
-                                               LayerType, nullptr);
+
+// =====================================================================
+// =====================================================================
+
+
+void VectorDataset::beginWriteSession(unsigned int BatchSize, unsigned int LayerIndex)
+{
+  if (mp_WriteLayer)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"A write session is already active");
+  }
+
+  OGRLayer* Layer = layer(LayerIndex);
 
   if (!Layer)
   {
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-                                              "Error while adding a layer to " + Path +
-                                              ": creation of layer " + LayerName + " failed.");
+                                              "Layer " + openfluid::tools::convertValue(LayerIndex) + " not found");
   }
 
-  // necessary to ensure headers are written out in an orderly way and all resources are recovered
-  GDALClose_COMPAT(mp_DataSource);
-
-  mp_DataSource = GDALOpenRW_COMPAT(Path.c_str());
+  mp_WriteLayer = Layer;
+  m_WriteBatchSize = std::max(1u,BatchSize);
 
-  if (!mp_DataSource)
+  try
   {
-    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-                                              "Error while opening " + Path + " : Opening of OGRDataSource failed.");
+    startWriteTransaction();
+  }
+  catch (openfluid::base::FrameworkException&)
+  {
+    mp_WriteLayer = nullptr;
+    throw;
   }
 }
 
@@ -456,9 +555,27 @@ void VectorDataset::addALayer(std::string LayerName,
 // =====================================================================
 
 
-OGRLayer* VectorDataset::layer(unsigned int LayerIndex)
+void VectorDataset::writeFeature(OGRFeature* Feature)
 {
-  return mp_DataSource->GetLayer(LayerIndex);
+  if (!mp_WriteLayer)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"No active write session");
+  }
+
+  if (mp_WriteLayer->SetFeature(Feature) != OGRERR_NONE)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Unable to write the feature FID " +
+                                              openfluid::tools::convertValue(Feature->GetFID()));
+  }
+
+  m_WrittenInBatch++;
+
+  if (m_WrittenInBatch >= m_WriteBatchSize)
+  {
+    commitWriteTransaction();
+    startWriteTransaction();
+  }
 }
 
 
@@ -466,9 +583,24 @@ OGRLayer* VectorDataset::layer(unsigned int LayerIndex)
 // =====================================================================
 
 
-OGRFeatureDefn* VectorDataset::layerDef(unsigned int LayerIndex)
+void VectorDataset::commitWriteSession()
 {
-  return layer(LayerIndex)->GetLayerDefn();
+  if (!mp_WriteLayer)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"No active write session");
+  }
+
+  try
+  {
+    commitWriteTransaction();
+  }
+  catch (openfluid::base::FrameworkException&)
+  {
+    mp_WriteLayer = nullptr;
+    throw;
+  }
+
+  mp_WriteLayer = nullptr;
 }
 
 
@@ -476,17 +608,24 @@ OGRFeatureDefn* VectorDataset::layerDef(unsigned int LayerIndex)
 // =====================================================================
 
 
-void VectorDataset::addAField(const std::string& FieldName,
-                              OGRFieldType FieldType,
-                              unsigned int LayerIndex)
+void VectorDataset::rollbackWriteSession()
 {
-  OGRFieldDefn Field(FieldName.c_str(), FieldType);
+  if (!mp_WriteLayer)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"No active write session");
+  }
 
-  if (layer(LayerIndex)->CreateField(&Field) != OGRERR_NONE)
+  try
   {
-    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-                                              "Creating field \"" + FieldName + "\" failed.");
+    rollbackWriteTransaction();
+  }
+  catch (openfluid::base::FrameworkException&)
+  {
+    mp_WriteLayer = nullptr;
+    throw;
   }
+
+  mp_WriteLayer = nullptr;
 }
 
 
@@ -494,9 +633,11 @@ void VectorDataset::addAField(const std::string& FieldName,
 // =====================================================================
 
 
-bool VectorDataset::isLineType(unsigned int LayerIndex)
+VectorDataset::WriteSessionGuard::WriteSessionGuard(VectorDataset* Vector, unsigned int BatchSize,
+                                                    unsigned int LayerIndex) :
+  mp_Vector(Vector), m_IsClosed(false)
 {
-  return layerDef(LayerIndex)->GetGeomType() == wkbLineString;
+  mp_Vector->beginWriteSession(BatchSize,LayerIndex);
 }
 
 
@@ -504,9 +645,19 @@ bool VectorDataset::isLineType(unsigned int LayerIndex)
 // =====================================================================
 
 
-bool VectorDataset::isPolygonType(unsigned int LayerIndex)
+VectorDataset::WriteSessionGuard::~WriteSessionGuard()
 {
-  return layerDef(LayerIndex)->GetGeomType() == wkbPolygon;
+  if (!m_IsClosed)
+  {
+    try
+    {
+      mp_Vector->rollbackWriteSession();
+    }
+    catch (openfluid::base::FrameworkException&)
+    {
+      // the session is ended anyway
+    }
+  }
 }
 
 
@@ -514,10 +665,11 @@ bool VectorDataset::isPolygonType(unsigned int LayerIndex)
 // =====================================================================
 
 
-bool VectorDataset::containsField(const std::string& FieldName,
-                                  unsigned int LayerIndex)
+void VectorDataset::WriteSessionGuard::commit()
 {
-  return layerDef(LayerIndex)->GetFieldIndex(FieldName.c_str()) != -1;
+  // commitWriteSession() ends the session even if it fails
+  m_IsClosed = true;
+  mp_Vector->commitWriteSession();
 }
 
 
@@ -525,20 +677,206 @@ bool VectorDataset::containsField(const std::string& FieldName,
 // =====================================================================
 
 
-int VectorDataset::getFieldIndex(const std::string& FieldName,
-                                 unsigned int LayerIndex)
+GDALDataset_COMPAT* VectorDataset::source()
 {
-  return layerDef(LayerIndex)->GetFieldIndex(FieldName.c_str());
+  return mp_DataSource;
 }
 
 
-// =====================================================================
+// =======================================y==============================
 // =====================================================================
 
 
-bool VectorDataset::isFieldOfType(const std::string& FieldName,
-                                  OGRFieldType FieldType,
-                                  unsigned int LayerIndex)
+GDALDataset_COMPAT* VectorDataset::source() const
+{
+  return mp_DataSource;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void VectorDataset::copyToDisk(const std::string& FilePath,
+                               const std::string& FileName,
+                               bool ReplaceIfExists)
+{
+  GDALDriver_COMPAT* Driver = mp_DataSource->GetDriver();
+
+  if (!openfluid::tools::Filesystem::isDirectory(FilePath))
+  {
+    openfluid::tools::Filesystem::makeDirectory(FilePath);
+  }
+
+  std::string Path = openfluid::core::GeoValue::computeAbsolutePath(FilePath,
+                                                                    FileName);
+
+  GDALDataset_COMPAT* DS = GDALOpenRO_COMPAT(Path.c_str());
+
+  if (DS)
+  {
+    if (ReplaceIfExists)
+    {
+      GDALDriver_COMPAT* Driver = DS->GetDriver();
+      GDALClose_COMPAT(DS);
+      GDALDelete_COMPAT(Driver,Path.c_str());
+    }
+    else
+    {
+      GDALClose_COMPAT(DS);
+      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                                "Error while creating " + Path +
+                                                " : This VectorDataset already exists.");
+    }
+  }
+
+  GDALDataset_COMPAT* NewDS = nullptr;
+
+  NewDS = GDALCopy_COMPAT(Driver,mp_DataSource,Path.c_str());
+
+  if (!NewDS)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Error while creating " + Path + " : Copying of OGRDataSource failed.");
+  }
+
+  // necessary to ensure headers are written out in an orderly way and all resources are recovered
+  GDALClose_COMPAT(NewDS);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void VectorDataset::addALayer(std::string LayerName,
+                              OGRwkbGeometryType LayerType,
+                              OGRSpatialReference* SpatialRef)
+{
+#if (GDAL_VERSION_MAJOR >= 2)
+  std::string Path = mp_DataSource->GetDescription();
+#else
+  std::string Path = mp_DataSource->GetName();
+#endif
+
+
+  if (mp_DataSource->GetLayerByName(LayerName.c_str()) != nullptr)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Error while adding a layer to " + Path +
+                                              ": a layer named " + LayerName + " already exists.");
+  }
+
+  OGRLayer* Layer = mp_DataSource->CreateLayer(LayerName.c_str(), SpatialRef,
+                                               LayerType, nullptr);
+
+  if (!Layer)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Error while adding a layer to " + Path +
+                                              ": creation of layer " + LayerName + " failed.");
+  }
+
+  // necessary to ensure headers are written out in an orderly way and all resources are recovered
+  GDALClose_COMPAT(mp_DataSource);
+
+  mp_DataSource = GDALOpenRW_COMPAT(Path.c_str());
+
+  if (!mp_DataSource)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Error while opening " + Path + " : Opening of OGRDataSource failed.");
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+OGRLayer* VectorDataset::layer(unsigned int LayerIndex)
+{
+  return mp_DataSource->GetLayer(LayerIndex);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+OGRFeatureDefn* VectorDataset::layerDef(unsigned int LayerIndex)
+{
+  return layer(LayerIndex)->GetLayerDefn();
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+void VectorDataset::addAField(const std::string& FieldName,
+                              OGRFieldType FieldType,
+                              unsigned int LayerIndex)
+{
+  OGRFieldDefn Field(FieldName.c_str(), FieldType);
+
+  if (layer(LayerIndex)->CreateField(&Field) != OGRERR_NONE)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Creating field \"" + FieldName + "\" failed.");
+  }
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool VectorDataset::isLineType(unsigned int LayerIndex)
+{
+  return layerDef(LayerIndex)->GetGeomType() == wkbLineString;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool VectorDataset::isPolygonType(unsigned int LayerIndex)
+{
+  return layerDef(LayerIndex)->GetGeomType() == wkbPolygon;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool VectorDataset::containsField(const std::string& FieldName,
+                                  unsigned int LayerIndex)
+{
+  return layerDef(LayerIndex)->GetFieldIndex(FieldName.c_str()) != -1;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+int VectorDataset::getFieldIndex(const std::string& FieldName,
+                                 unsigned int LayerIndex)
+{
+  return layerDef(LayerIndex)->GetFieldIndex(FieldName.c_str());
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+bool VectorDataset::isFieldOfType(const std::string& FieldName,
+                                  OGRFieldType FieldType,
+                                  unsigned int LayerIndex)
 {
   if (!containsField(FieldName))
   {
@@ -609,7 +947,23 @@ geos::geom::Geometry* VectorDataset::geometries(unsigned int LayerIndex)
 {
   if (!m_Geometries.count(LayerIndex))
   {
-    parse(LayerIndex);
+    FeaturesList_t Features = features(LayerIndex);
+
+    std::vector<geos::geom::Geometry*>* Geoms = new std::vector<geos::geom::Geometry*>();
+
+    for (FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
+    {
+      Geoms->push_back((*it).second);
+    }
+
+    // ! do not use buildGeometry, because it may build a MultiPolygon if all geometries
+    //are Polygons, what may produce an invalid MultiPolygon!
+    // (because the boundaries of any two Polygons of a valid MultiPolygon may touch,
+    //*but only at a finite number of points*)
+    // the collection is not validated again, as each of its geometries has been validated while parsing
+    geos::geom::GeometryCollection* GTMP =
+        geos::geom::GeometryFactory::getDefaultInstance()->createGeometryCollection(Geoms);
+    m_Geometries.insert(std::make_pair(LayerIndex,GTMP));
   }
 
   return m_Geometries.at(LayerIndex);
@@ -620,11 +974,33 @@ geos::geom::Geometry* VectorDataset::geometries(unsigned int LayerIndex)
 // =====================================================================
 
 
+const GeometriesView& VectorDataset::geometriesView(unsigned int LayerIndex)
+{
+  if (!m_Views.count(LayerIndex))
+  {
+    FeaturesList_t Features = features(LayerIndex);
+
+    std::vector<const geos::geom::Geometry*> Geoms;
+
+    for (FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
+    {
+      Geoms.push_back((*it).second);
+    }
+
+    m_Views[LayerIndex].reset(new GeometriesView(Geoms));
+  }
+
+  return *m_Views.at(LayerIndex);
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 // TODO add an option to allow choice of checking validity or not (because it's time consuming)
 void VectorDataset::parse(unsigned int LayerIndex)
 {
-  std::vector<geos::geom::Geometry*>* Geoms = new std::vector<geos::geom::Geometry*>();
-
   // TODO Should this line be moved?
   setlocale(LC_NUMERIC, "C");
 
@@ -670,29 +1046,12 @@ void VectorDataset::parse(unsigned int LayerIndex)
     geos::geom::Geometry* GeomClone = GeosGeom->clone().release();
     OGRFeature* FeatClone = Feat->Clone();
 
-    Geoms->push_back(GeomClone);
     m_Features.at(LayerIndex).push_back(std::make_pair(FeatClone,GeomClone));
 
     // destroying the feature destroys also the associated OGRGeom
     OGRFeature::DestroyFeature(Feat);
     delete GeosGeom;
   }
-
-  // ! do not use buildGeometry, because it may build a MultiPolygon if all geometries
-  //are Polygons, what may produce an invalid MultiPolygon!
-  // (because the boundaries of any two Polygons of a valid MultiPolygon may touch,
-  //*but only at a finite number of points*)
-  geos::geom::GeometryCollection* GTMP = geos::geom::GeometryFactory::getDefaultInstance()->createGeometryCollection(Geoms);
-  m_Geometries.insert(std::make_pair(LayerIndex,GTMP));
-
-  geos::operation::valid::IsValidOp ValidOpColl(m_Geometries.at(LayerIndex));
-
-  if (!ValidOpColl.isValid())
-  {
-    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-                                              ValidOpColl.getValidationError()->toString() + " \nwhile creating " +
-                                              m_Geometries.at(LayerIndex)->toString());
-  }
 }
 
 
@@ -732,15 +1091,19 @@ void VectorDataset::setIndexIntField(const std::string& FieldName,
 
   Layer->ResetReading();
 
+  WriteSessionGuard Session(this,1000,LayerIndex);
+
   OGRFeature* Feat;
   while ((Feat = Layer->GetNextFeature()) != nullptr)
   {
+    std::unique_ptr<OGRFeature,decltype(&OGRFeature::DestroyFeature)> FeatPtr(Feat,&OGRFeature::DestroyFeature);
+
     Feat->SetField(FieldName.c_str(),BeginValue);
-    Layer->SetFeature(Feat);
-    OGRFeature::DestroyFeature(Feat);
+    writeFeature(Feat);
     BeginValue++;
   }
 
+  Session.commit();
 }
 
 
@@ -784,94 +1147,223 @@ void VectorDataset::snapVertices(double Threshold,unsigned int LayerIndex)
 // =====================================================================
 
 
-void VectorDataset::snapLineNodes(double Threshold,unsigned int LayerIndex)
+bool VectorDataset::snapCoordinates(std::vector<geos::geom::Coordinate>& Coords,
+                                    const std::vector<unsigned int>& Owners,
+                                    double Threshold)
 {
+  if (Threshold <= 0 || Coords.empty())
+  {
+    return false;
+  }
 
-  FeaturesList_t Features = features(LayerIndex);
+  struct CellHash
+  {
+    std::size_t operator()(const std::pair<long long, long long>& Cell) const
+    {
+      return std::hash<long long>()(Cell.first) * 31 + std::hash<long long>()(Cell.second);
+    }
+  };
 
-  for (FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
+  typedef std::pair<long long, long long> Cell_t;
+
+  struct Position
+  {
+    geos::geom::Coordinate Coord;
+    std::vector<unsigned int> Vertices;
+    std::set<unsigned int> Owners;
+  };
+
+  // coinciding vertices are grouped, they are already snapped together and never split
+  std::map<geos::geom::Coordinate, Position, geos::geom::CoordinateLessThen> PositionsMap;
+
+  for (unsigned int i = 0; i < Coords.size(); i++)
+  {
+    Position& Pos = PositionsMap[Coords[i]];
+    Pos.Coord = Coords[i];
+    Pos.Vertices.push_back(i);
+    Pos.Owners.insert(Owners[i]);
+  }
+
+  // the most shared positions are processed first, then in (x,y) order,
+  // so that the result does not depend on the order of the vertices
+  std::vector<const Position*> Positions;
+  for (const auto& Pos : PositionsMap)
+  {
+    Positions.push_back(&Pos.second);
+  }
+
+  std::stable_sort(Positions.begin(),Positions.end(),[](const Position* P1, const Position* P2)
   {
-    geos::geom::Geometry *Geom=geometries();
+    return P1->Owners.size() > P2->Owners.size();
+  });
 
-    geos::geom::LineString *CurrentLine=(dynamic_cast<geos::geom::LineString*>((*it).second));
-    // get a vector of StartPoint and EndPoint of all Geometries
-    // except the current Geometry
-    std::vector<geos::geom::Point*> vPoints;
-    unsigned int iEnd = Geom->getNumGeometries();
+  // each cluster is limited to the threshold around its representative, which never moves
+  std::vector<Position> Representatives;
+  std::unordered_map<Cell_t, std::vector<unsigned int>, CellHash> Grid;
 
-    for (unsigned int i = 0; i < iEnd; i++)
+  auto cellOf = [Threshold](const geos::geom::Coordinate& Coord)
+  {
+    return std::make_pair((long long) std::floor(Coord.x / Threshold),
+                          (long long) std::floor(Coord.y / Threshold));
+  };
+
+  auto areDisjoint = [](const std::set<unsigned int>& Set1, const std::set<unsigned int>& Set2)
+  {
+    for (unsigned int Owner : Set1)
     {
-      if (!(const_cast<geos::geom::Geometry*>(Geom->getGeometryN(i)))->equals((*it).second))
+      if (Set2.count(Owner))
       {
-        geos::geom::LineString *Line =
-            dynamic_cast<geos::geom::LineString*>(const_cast<geos::geom::Geometry*>(Geom->getGeometryN(i)));
-        vPoints.push_back(Line->getStartPoint().release());
-        vPoints.push_back(Line->getEndPoint().release());
+        return false;
       }
     }
+    return true;
+  };
 
-    geos::geom::Point* PStart = CurrentLine->getStartPoint().release();
-    geos::geom::Point* PEnd = CurrentLine->getEndPoint().release();
-    geos::geom::Point* NewPStart = nullptr;
-    geos::geom::Point* NewPEnd = nullptr;
+  bool Moved = false;
 
-    for (unsigned int j = 0; j < vPoints.size(); j++)
+  for (const Position* Pos : Positions)
+  {
+    Cell_t Cell = cellOf(Pos->Coord);
+    int Nearest = -1;
+    double NearestDistance = Threshold;
+
+    // representatives under the threshold are in the 9 cells around the cell of the position
+    for (long long dx = -1; dx <= 1; dx++)
     {
-      if (!PStart->equals(vPoints.at(j)) && PStart->equalsExact(vPoints.at(j),Threshold))
-      {
-        NewPStart = vPoints.at(j);
-      }
-      if (!PEnd->equals(vPoints.at(j)) && PEnd->equalsExact(vPoints.at(j),Threshold))
+      for (long long dy = -1; dy <= 1; dy++)
       {
-        NewPEnd = vPoints.at(j);
+        auto Found = Grid.find(std::make_pair(Cell.first + dx, Cell.second + dy));
+
+        if (Found == Grid.end())
+        {
+          continue;
+        }
+
+        for (unsigned int r : Found->second)
+        {
+          double Distance = Pos->Coord.distance(Representatives[r].Coord);
+
+          // a vertex is never snapped onto another vertex of the same owner,
+          // the threshold is included and the first found representative is kept in case of tie
+          if ((Nearest < 0 ? Distance <= NearestDistance : Distance < NearestDistance) &&
+              areDisjoint(Pos->Owners,Representatives[r].Owners))
+          {
+            Nearest = r;
+            NearestDistance = Distance;
+          }
+        }
       }
     }
 
-    if (!NewPStart && !NewPEnd)
+    if (Nearest < 0)
     {
-      continue;  // TODO to be replaced!
+      Grid[Cell].push_back(Representatives.size());
+      Representatives.push_back(*Pos);
+      continue;
     }
 
-    geos::geom::CoordinateSequence* CoordSeq=CurrentLine->getCoordinates().release();
-    if (NewPStart)
-    {
-      CoordSeq->setAt(*NewPStart->getCoordinate(),0);
-    }
+    Position& Representative = Representatives[Nearest];
+    Representative.Owners.insert(Pos->Owners.begin(),Pos->Owners.end());
 
-    if (NewPEnd)
+    for (unsigned int i : Pos->Vertices)
     {
-      CoordSeq->setAt(*NewPEnd->getCoordinate(),CoordSeq->getSize()-1);
+      Coords[i] = Representative.Coord;
     }
+    Moved = true;
+  }
 
-    geos::geom::LineString* NewLine = geos::geom::GeometryFactory::getDefaultInstance()->createLineString(CoordSeq);
-    OGRGeometry* OGRGeom =
-      openfluid::landr::convertGEOSGeometryToOGR((GEOSGeom) dynamic_cast<geos::geom::Geometry*>(NewLine));
-    OGRFeature* OGRFeat = (*it).first;
-    OGRFeat->SetGeometry(OGRGeom);
-    geos::geom::Geometry* NewLineClone = NewLine->clone().release();
-    OGRFeature* OGRFeatClone = OGRFeat->Clone();
-    (*it) = std::make_pair<OGRFeature*, geos::geom::Geometry*>
-    (dynamic_cast<OGRFeature *>(OGRFeat), dynamic_cast<geos::geom::Geometry*>(NewLineClone));
-    mp_DataSource->GetLayer(LayerIndex)->SetFeature(OGRFeatClone);
-    m_Geometries.clear();
+  return Moved;
+}
 
-    delete NewLine;
-    OGRFeature::DestroyFeature(OGRFeat);
-    delete PStart;
-    delete PEnd;
-    delete NewPStart;
-    delete NewPEnd;
-    delete CurrentLine;
 
-    try
+// =====================================================================
+// =====================================================================
+
+
+void VectorDataset::snapLineNodes(double Threshold,unsigned int LayerIndex)
+{
+  FeaturesList_t Features = features(LayerIndex);
+
+  // start and end points of all the lines are snapped together in one pass
+  std::vector<geos::geom::Coordinate> Coords;
+  std::vector<unsigned int> Owners;
+  std::vector<FeaturesList_t::iterator> Lines;
+
+  for (FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
+  {
+    geos::geom::LineString* Line = dynamic_cast<geos::geom::LineString*>((*it).second);
+
+    if (!Line || Line->isEmpty())
     {
-      parse(LayerIndex);
+      continue;
     }
-    catch (std::exception& e)
+
+    Coords.push_back(Line->getCoordinateN(0));
+    Coords.push_back(Line->getCoordinateN(Line->getNumPoints()-1));
+    Owners.push_back(Lines.size());
+    Owners.push_back(Lines.size());
+    Lines.push_back(it);
+  }
+
+  std::vector<geos::geom::Coordinate> OriginalCoords(Coords);
+
+  if (!snapCoordinates(Coords,Owners,Threshold))
+  {
+    return;
+  }
+
+  WriteSessionGuard Session(this,1000,LayerIndex);
+
+  for (unsigned int l = 0; l < Lines.size(); l++)
+  {
+    const geos::geom::Coordinate& NewStart = Coords[2*l];
+    const geos::geom::Coordinate& NewEnd = Coords[2*l+1];
+
+    if (NewStart.equals2D(OriginalCoords[2*l]) && NewEnd.equals2D(OriginalCoords[2*l+1]))
     {
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-                                                "Unable to parse the VectorDataset (" + std::string(e.what()) + ")");
+      continue;
     }
+
+    geos::geom::LineString* CurrentLine = dynamic_cast<geos::geom::LineString*>((*Lines[l]).second);
+    geos::geom::CoordinateSequence* CoordSeq = CurrentLine->getCoordinates().release();
+
+    // a line collapsed by the snapping is kept unchanged
+    if (CoordSeq->getSize() == 2 && NewStart.equals2D(NewEnd))
+    {
+      delete CoordSeq;
+      continue;
+    }
+
+    CoordSeq->setAt(NewStart,0);
+    CoordSeq->setAt(NewEnd,CoordSeq->getSize()-1);
+
+    geos::geom::LineString* NewLine = geos::geom::GeometryFactory::getDefaultInstance()->createLineString(CoordSeq);
+    OGRGeometry* OGRGeom =
+      openfluid::landr::convertGEOSGeometryToOGR((GEOSGeom) dynamic_cast<geos::geom::Geometry*>(NewLine));
+    OGRFeature* OGRFeatClone = (*Lines[l]).first->Clone();
+
+    OGRFeatClone->SetGeometry(OGRGeom);
+    writeFeature(OGRFeatClone);
+
+    OGRFeature::DestroyFeature(OGRFeatClone);
+    delete OGRGeom;
+    delete NewLine;
+  }
+
+  Session.commit();
+
+  // the layer is parsed once all the features are updated
+  m_Features.clear();
+  m_Geometries.clear();
+  m_Views.clear();
+  try
+  {
+    parse(LayerIndex);
+  }
+  catch (std::exception& e)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Unable to parse the VectorDataset (" + std::string(e.what()) + ")");
   }
 }
 
@@ -884,81 +1376,124 @@ void VectorDataset::snapPolygonVertices(double Threshold,unsigned int LayerIndex
 {
   FeaturesList_t Features = features(LayerIndex);
 
+  // all the rings of all the polygons are gathered, snapped in one pass,
+  // then the polygons are rebuilt from their rings
+  std::vector<geos::geom::Coordinate> Coords;
+  std::vector<unsigned int> Owners;
+  std::vector<FeaturesList_t::iterator> Polygons;
+  std::vector<std::vector<unsigned int> > RingsSizes;
+
   for (FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
   {
-    // FIXME Crashes may happen here
-    geos::geom::Geometry* Geom = geometries();
-    geos::geom::Polygon* CurrentPolygon = (dynamic_cast<geos::geom::Polygon*>((*it).second));
+    geos::geom::Polygon* Polygon = dynamic_cast<geos::geom::Polygon*>((*it).second);
 
-    // get a vector of the Coordinates of the vertices of all Geometries
-    // except the current Geometry
-    std::vector<geos::geom::Coordinate> vCoor;
-    unsigned int iEnd = Geom->getNumGeometries();
+    if (!Polygon)
+    {
+      continue;
+    }
+
+    std::vector<unsigned int> Sizes;
 
-    for (unsigned int i = 0; i < iEnd; i++)
+    for (int r = -1; r < (int)Polygon->getNumInteriorRing(); r++)
     {
+      const geos::geom::LineString* Ring = (r < 0 ? Polygon->getExteriorRing() : Polygon->getInteriorRingN(r));
+      std::unique_ptr<geos::geom::CoordinateSequence> RingCoords = Ring->getCoordinates();
 
-      if (!(const_cast<geos::geom::Geometry*>(Geom->getGeometryN(i)))->equals((*it).second))
+      for (unsigned int c = 0; c < RingCoords->getSize(); c++)
       {
-        geos::geom::Polygon *Polygon=
-            (dynamic_cast<geos::geom::Polygon*>(const_cast<geos::geom::Geometry*>(Geom->getGeometryN(i))));
-
-        if (Polygon)
-        {
-          geos::geom::CoordinateArraySequence(*(Polygon->getCoordinates().get())).toVector(vCoor);
-        }
-        delete Polygon;
+        Coords.push_back(RingCoords->getAt(c));
+        Owners.push_back(Polygons.size());
       }
+      Sizes.push_back(RingCoords->getSize());
     }
 
-    std::vector<geos::geom::Coordinate> vCoorCurrentGeom;
-    geos::geom::CoordinateArraySequence(*(CurrentPolygon->getCoordinates().get())).toVector(vCoorCurrentGeom);
+    Polygons.push_back(it);
+    RingsSizes.push_back(Sizes);
+  }
+
+  std::vector<geos::geom::Coordinate> OriginalCoords(Coords);
+
+  if (!snapCoordinates(Coords,Owners,Threshold))
+  {
+    return;
+  }
+
+  const geos::geom::GeometryFactory* Factory = geos::geom::GeometryFactory::getDefaultInstance();
+  unsigned int Offset = 0;
 
-    geos::geom::CoordinateSequence* CoordSeq = CurrentPolygon->getCoordinates().release();
-    for (unsigned int j = 0; j < vCoorCurrentGeom.size(); j++)
+  WriteSessionGuard Session(this,1000,LayerIndex);
+
+  for (unsigned int p = 0; p < Polygons.size(); p++)
+  {
+    bool Moved = false;
+    bool IsValidRing = true;
+    std::vector<std::vector<geos::geom::Coordinate> > Rings;
+
+    for (unsigned int r = 0; r < RingsSizes[p].size(); r++)
     {
-      for (unsigned int h = 0; h < vCoor.size(); h++)
+      std::vector<geos::geom::Coordinate> Ring;
+
+      for (unsigned int c = Offset; c < Offset + RingsSizes[p][r]; c++)
       {
-        if (!vCoorCurrentGeom.at(j).equals(vCoor.at(h)) &&
-            vCoorCurrentGeom.at(j).distance(vCoor.at(h)) > 0 &&
-            vCoorCurrentGeom.at(j).distance(vCoor.at(h)) < Threshold)
+        Moved = Moved || !Coords[c].equals2D(OriginalCoords[c]);
+
+        // consecutive vertices snapped to the same position are merged
+        if (Ring.empty() || !Ring.back().equals2D(Coords[c]))
         {
-          CoordSeq->setAt(vCoor.at(h),j);
+          Ring.push_back(Coords[c]);
         }
       }
+
+      Offset += RingsSizes[p][r];
+      IsValidRing = IsValidRing && Ring.size() >= 4;
+      Rings.push_back(Ring);
     }
 
-    geos::geom::Polygon* NewPolygon=geos::geom::GeometryFactory::getDefaultInstance()->createPolygon(
-        geos::geom::GeometryFactory::getDefaultInstance()->createLinearRing(CoordSeq),nullptr);
+    // a polygon collapsed by the snapping is kept unchanged
+    if (!Moved || !IsValidRing)
+    {
+      continue;
+    }
+
+    geos::geom::LinearRing* Shell =
+        Factory->createLinearRing(new geos::geom::CoordinateArraySequence(
+            new std::vector<geos::geom::Coordinate>(Rings[0])));
+
+    std::vector<geos::geom::LinearRing*>* Holes = new std::vector<geos::geom::LinearRing*>();
+    for (unsigned int r = 1; r < Rings.size(); r++)
+    {
+      Holes->push_back(Factory->createLinearRing(new geos::geom::CoordinateArraySequence(
+          new std::vector<geos::geom::Coordinate>(Rings[r]))));
+    }
+
+    geos::geom::Polygon* NewPolygon = Factory->createPolygon(Shell,Holes);
 
     OGRGeometry* OGRGeom =
         openfluid::landr::convertGEOSGeometryToOGR((GEOSGeom) dynamic_cast<geos::geom::Geometry*>(NewPolygon));
-    OGRFeature* OGRFeat = (*it).first;
-
-    OGRFeat->SetGeometry(OGRGeom);
-    OGRFeature* OGRFeatClone = OGRFeat->Clone();
-    geos::geom::Geometry* NewPolygonClone = NewPolygon->clone().release();
-    (*it) = std::make_pair<OGRFeature*, geos::geom::Geometry*>
-    (dynamic_cast<OGRFeature *>(OGRFeatClone), dynamic_cast<geos::geom::Geometry*>(NewPolygonClone));
+    OGRFeature* OGRFeatClone = (*Polygons[p]).first->Clone();
 
-    mp_DataSource->GetLayer(LayerIndex)->SetFeature(OGRFeatClone);
+    OGRFeatClone->SetGeometry(OGRGeom);
+    writeFeature(OGRFeatClone);
 
     OGRFeature::DestroyFeature(OGRFeatClone);
-    delete NewPolygonClone;
-    delete CoordSeq;
-    delete CurrentPolygon;
+    delete OGRGeom;
+    delete NewPolygon;
+  }
 
-    m_Geometries.clear();
-    try
-    {
-      parse(LayerIndex);
+  Session.commit();
 
-    }
-    catch (std::exception& e)
-    {
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-                                                "Unable to parse the VectorDataset (" + std::string(e.what()) + ")");
-    }
+  // the layer is parsed once all the features are updated
+  m_Features.clear();
+  m_Geometries.clear();
+  m_Views.clear();
+  try
+  {
+    parse(LayerIndex);
+  }
+  catch (std::exception& e)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Unable to parse the VectorDataset (" + std::string(e.what()) + ")");
   }
 }
 
@@ -967,14 +1502,16 @@ void VectorDataset::snapPolygonVertices(double Threshold,unsigned int LayerIndex
 // =====================================================================
 
 
-std::string VectorDataset::checkTopology(double Threshold, unsigned int LayerIndex)
+std::vector<VectorDataset::TopologyError> VectorDataset::computeTopologyReport(double Threshold,
+                                                                               unsigned int LayerIndex,
+                                                                               unsigned int ThreadsCount)
 {
   if ( ! isPolygonType(LayerIndex))
   {
     throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"the VectorDataset is not Polygon type");
   }
 
-  std::string ErrorMsg;
+  std::vector<TopologyError> Report;
 
   // TODO Should this line be moved?
   setlocale(LC_NUMERIC, "C");
@@ -983,55 +1520,204 @@ std::string VectorDataset::checkTopology(double Threshold, unsigned int LayerInd
 
   Layer->ResetReading();
 
+  // the layer is read sequentially, the features are checked in parallel
+  std::vector<OGRFeature*> Feats;
   OGRFeature* Feat;
 
-  FeaturesList_t List;
-  m_Features.insert(std::make_pair(LayerIndex, List));
-
   // GetNextFeature returns a copy of the feature
   while ((Feat = Layer->GetNextFeature()) != nullptr)
   {
-    OGRGeometry* OGRGeom = Feat->GetGeometryRef();
+    Feats.push_back(Feat);
+  }
 
-    // c++ cast doesn't work (have to use C-style casting instead)
-    geos::geom::Geometry* GeosGeom = (geos::geom::Geometry*) openfluid::landr::convertOGRGeometryToGEOS(OGRGeom);
+  std::vector<std::unique_ptr<TopologyError> > Invalids(Feats.size());
 
-    geos::operation::valid::IsValidOp ValidOp(GeosGeom);
+  const unsigned int ChunkSize = 64;
+  const unsigned int ChunksCount = (Feats.size() + ChunkSize - 1) / ChunkSize;
 
-    if (!ValidOp.isValid())
+  LandRTools::runInParallel(ChunksCount,[&](unsigned int Chunk)
+  {
+    GEOSContextHandle_t ContextHandle = OGRGeometry::createGEOSContext();
+
+    for (unsigned int i = Chunk * ChunkSize; i < std::min<std::size_t>((Chunk + 1) * ChunkSize,Feats.size()); i++)
+    {
+      // c++ cast doesn't work (have to use C-style casting instead)
+      std::unique_ptr<geos::geom::Geometry> GeosGeom(
+          (geos::geom::Geometry*) openfluid::landr::convertOGRGeometryToGEOS(Feats[i]->GetGeometryRef(),
+                                                                            ContextHandle));
+
+      geos::operation::valid::IsValidOp ValidOp(GeosGeom.get());
+
+      if (!ValidOp.isValid())
+      {
+        const geos::operation::valid::TopologyValidationError* Error = ValidOp.getValidationError();
+
+        Invalids[i].reset(new TopologyError());
+        Invalids[i]->FID = Feats[i]->GetFID();
+        Invalids[i]->Class = TopologyError::INVALID_GEOMETRY;
+        Invalids[i]->X = Error->getCoordinate().x;
+        Invalids[i]->Y = Error->getCoordinate().y;
+        Invalids[i]->NeighbourFID = OGRNullFID;
+        Invalids[i]->Message = Error->toString();
+      }
+    }
+
+    OGRGeometry::freeGEOSContext(ContextHandle);
+  },ThreadsCount);
+
+  for (unsigned int i = 0; i < Feats.size(); i++)
+  {
+    if (Invalids[i])
     {
-      ErrorMsg += "\n " + ValidOp.getValidationError()->toString() +
-                  " FID "+openfluid::tools::convertValue(Feat->GetFID());
+      Report.push_back(*Invalids[i]);
     }
 
     // destroying the feature destroys also the associated OGRGeom
-    OGRFeature::DestroyFeature(Feat);
-    delete GeosGeom;
+    OGRFeature::DestroyFeature(Feats[i]);
+  }
+
+  // overlaps and gaps are located on the geometries parsed by findOverlap and findGap
+  auto appendPairs = [&](const std::list<std::pair<OGRFeature*,OGRFeature*> >& Pairs,
+                         TopologyError::ErrorClass Class)
+  {
+    std::map<OGRFeature*, geos::geom::Geometry*> GeomsOfFeatures;
+    FeaturesList_t Features = features(LayerIndex);
+
+    for (FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
+    {
+      GeomsOfFeatures[(*it).first] = (*it).second;
+    }
+
+    std::vector<std::pair<OGRFeature*,OGRFeature*> > PairsVect(Pairs.begin(),Pairs.end());
+    std::vector<TopologyError> Errors(PairsVect.size());
+
+    // each pair is located by a single task, which writes only its own error
+    LandRTools::runInParallel(PairsVect.size(),[&](unsigned int p)
+    {
+      geos::geom::Geometry* Geom1 = GeomsOfFeatures.at(PairsVect[p].first);
+      geos::geom::Geometry* Geom2 = GeomsOfFeatures.at(PairsVect[p].second);
+
+      TopologyError& Error = Errors[p];
+      Error.FID = PairsVect[p].first->GetFID();
+      Error.Class = Class;
+      Error.NeighbourFID = PairsVect[p].second->GetFID();
+
+      geos::geom::Coordinate Location;
+
+      if (Class == TopologyError::OVERLAP)
+      {
+        std::unique_ptr<geos::geom::Point> Point = Geom1->intersection(Geom2)->getInteriorPoint();
+        Location = *(Point->getCoordinate());
+      }
+      else
+      {
+        std::unique_ptr<geos::geom::CoordinateSequence> Nearest =
+            geos::operation::distance::DistanceOp::nearestPoints(Geom1,Geom2);
+        Location.x = (Nearest->getAt(0).x + Nearest->getAt(1).x) / 2;
+        Location.y = (Nearest->getAt(0).y + Nearest->getAt(1).y) / 2;
+      }
+
+      Error.X = Location.x;
+      Error.Y = Location.y;
+    },ThreadsCount);
+
+    Report.insert(Report.end(),Errors.begin(),Errors.end());
+  };
+
+  appendPairs(findOverlap(LayerIndex,ThreadsCount),TopologyError::OVERLAP);
+  appendPairs(findGap(Threshold,LayerIndex,ThreadsCount),TopologyError::GAP);
+
+  return Report;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::string VectorDataset::checkTopology(double Threshold, unsigned int LayerIndex)
+{
+  std::vector<TopologyError> Report = computeTopologyReport(Threshold,LayerIndex);
+
+  std::string ErrorMsg;
+
+  for (std::vector<TopologyError>::const_iterator it = Report.begin(); it != Report.end(); ++it)
+  {
+    if ((*it).Class == TopologyError::INVALID_GEOMETRY)
+    {
+      ErrorMsg += "\n " + (*it).Message + " FID "+openfluid::tools::convertValue((*it).FID);
+    }
+    else if ((*it).Class == TopologyError::OVERLAP)
+    {
+      ErrorMsg += "\nPolygon FID " + openfluid::tools::convertValue((*it).FID) +
+                  " overlaps with Polygon FID " + openfluid::tools::convertValue((*it).NeighbourFID);
+    }
+    else
+    {
+      ErrorMsg += "\nPolygon FID " + openfluid::tools::convertValue((*it).FID) +
+                  " has a gap with Polygon FID "+ openfluid::tools::convertValue((*it).NeighbourFID);
+    }
   }
 
-  // test if overlap
-  std::list<std::pair<OGRFeature*,OGRFeature*>> lOverlaps=findOverlap(LayerIndex);
-  std::list<std::pair<OGRFeature*,OGRFeature*>>::iterator it= lOverlaps.begin();
-  std::list<std::pair<OGRFeature*,OGRFeature*>>::iterator ite= lOverlaps.end();
+  return ErrorMsg;
+}
+
+
+// =====================================================================
+// =====================================================================
 
-  for(;it != ite; ++it)
+
+std::vector<std::pair<unsigned int, unsigned int> > VectorDataset::computeCandidatePairs(
+    const std::vector<geos::geom::Geometry*>& Geoms, double Distance)
+{
+  std::vector<std::pair<unsigned int, unsigned int> > Pairs;
+
+  if (Geoms.empty())
   {
-    ErrorMsg += "\nPolygon FID " + openfluid::tools::convertValue((*it).first->GetFID()) +
-                " overlaps with Polygon FID " + openfluid::tools::convertValue((*it).second->GetFID());
+    return Pairs;
   }
 
-  // test if gap
-  std::list<std::pair<OGRFeature*,OGRFeature*>> lGaps = findGap(Threshold,LayerIndex);
-  std::list<std::pair<OGRFeature*,OGRFeature*>>::iterator jt = lGaps.begin();
-  std::list<std::pair<OGRFeature*,OGRFeature*>>::iterator jte = lGaps.end();
+  // the tree keeps pointers to the envelopes, which are owned by the geometries
+  geos::index::strtree::STRtree Index;
 
-  for(;jt != jte; ++jt)
+  for (unsigned int i = 0; i < Geoms.size(); i++)
   {
-    ErrorMsg += "\nPolygon FID " + openfluid::tools::convertValue((*jt).first->GetFID()) +
-                " has a gap with Polygon FID "+ openfluid::tools::convertValue((*jt).second->GetFID());
+    Index.insert(Geoms[i]->getEnvelopeInternal(), const_cast<geos::geom::Geometry**>(&Geoms[i]));
   }
 
-  return ErrorMsg;
+  std::vector<void*> Matches;
+  std::vector<unsigned int> Candidates;
+
+  for (unsigned int i = 0; i < Geoms.size(); i++)
+  {
+    geos::geom::Envelope SearchEnv(*Geoms[i]->getEnvelopeInternal());
+    SearchEnv.expandBy(Distance);
+
+    Matches.clear();
+    Index.query(&SearchEnv, Matches);
+
+    Candidates.clear();
+    for (unsigned int m = 0; m < Matches.size(); m++)
+    {
+      unsigned int j = static_cast<geos::geom::Geometry**>(Matches[m]) - &Geoms[0];
+
+      // keeping only j > i emits each unordered pair once
+      if (j > i)
+      {
+        Candidates.push_back(j);
+      }
+    }
+
+    // the order of the tree matches is not specified
+    std::sort(Candidates.begin(), Candidates.end());
+
+    for (unsigned int c = 0; c < Candidates.size(); c++)
+    {
+      Pairs.push_back(std::make_pair(i, Candidates[c]));
+    }
+  }
+
+  return Pairs;
 }
 
 
@@ -1039,7 +1725,30 @@ std::string VectorDataset::checkTopology(double Threshold, unsigned int LayerInd
 // =====================================================================
 
 
-std::list<std::pair<OGRFeature*, OGRFeature*> > VectorDataset::findOverlap(unsigned int LayerIndex)
+std::vector<unsigned int> VectorDataset::computeCandidateRanges(
+    const std::vector<std::pair<unsigned int, unsigned int> >& Candidates)
+{
+  std::vector<unsigned int> RangesBegin;
+
+  for (unsigned int c = 0; c < Candidates.size(); c++)
+  {
+    if (c == 0 || Candidates[c].first != Candidates[c-1].first)
+    {
+      RangesBegin.push_back(c);
+    }
+  }
+  RangesBegin.push_back(Candidates.size());
+
+  return RangesBegin;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+std::list<std::pair<OGRFeature*, OGRFeature*> > VectorDataset::findOverlap(unsigned int LayerIndex,
+                                                                           unsigned int ThreadsCount)
 {
   if (!isPolygonType(LayerIndex))
   {
@@ -1048,32 +1757,55 @@ std::list<std::pair<OGRFeature*, OGRFeature*> > VectorDataset::findOverlap(unsig
 
   m_Features.clear();
   m_Geometries.clear();
+  m_Views.clear();
   std::list<std::pair<OGRFeature*,OGRFeature*>> lOverlaps;
   FeaturesList_t Features = features(LayerIndex);
 
+  std::vector<OGRFeature*> Feats;
+  std::vector<geos::geom::Geometry*> Geoms;
+
   for (FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
   {
-    FeaturesList_t FeaturesToTest=features(LayerIndex);
-    for (FeaturesList_t::iterator jt = FeaturesToTest.begin(); jt != FeaturesToTest.end(); ++jt)
+    Feats.push_back((*it).first);
+    Geoms.push_back((*it).second);
+  }
+
+  std::vector<std::pair<unsigned int, unsigned int> > Candidates = computeCandidatePairs(Geoms);
+
+  // one task per range of candidates sharing the same first index, so each geometry is prepared once
+  std::vector<unsigned int> TasksBegin = computeCandidateRanges(Candidates);
+
+  // each task writes only its own slot, no lock is needed
+  std::vector<std::vector<unsigned int> > OverlapsByTask(TasksBegin.size()-1);
+
+  openfluid::landr::LandRTools::runInParallel(OverlapsByTask.size(),[&](unsigned int t)
+  {
+    unsigned int i = Candidates[TasksBegin[t]].first;
+
+    std::unique_ptr<geos::geom::prep::PreparedGeometry> PreparedGeom(
+        geos::geom::prep::PreparedGeometryFactory::prepare(Geoms[i]));
+
+    for (unsigned int c = TasksBegin[t]; c < TasksBegin[t+1]; c++)
     {
-      //test if overlap
-      if (!(*it).first->GetGeometryRef()->Equals((*jt).first->GetGeometryRef())
-          && (*it).first->GetGeometryRef()->Overlaps((*jt).first->GetGeometryRef()))
-      {
-        std::list<std::pair<OGRFeature*, OGRFeature*>>::iterator lt;
-        std::list<std::pair<OGRFeature*, OGRFeature*>>::iterator lt2;
-        std::pair<OGRFeature*, OGRFeature*> pair1 ((*it).first, (*jt).first);
-        std::pair<OGRFeature*, OGRFeature*> pair2 ((*jt).first, (*it).first);
-
-        lt = std::find(lOverlaps.begin(), lOverlaps.end(), pair1);
-        lt2 = std::find (lOverlaps.begin(), lOverlaps.end(), pair2);
-        if (lt == lOverlaps.end() && lt2 == lOverlaps.end())
-        {
-          lOverlaps.push_back(pair1);
-        }
+      unsigned int j = Candidates[c].second;
 
+      // the prepared intersection test discards most of the candidates before the full overlap test
+      // (equal geometries never overlap)
+      if (PreparedGeom->intersects(Geoms[j]) && Geoms[i]->overlaps(Geoms[j]))
+      {
+        OverlapsByTask[t].push_back(j);
       }
     }
+  },ThreadsCount);
+
+  for (unsigned int t = 0; t < OverlapsByTask.size(); t++)
+  {
+    unsigned int i = Candidates[TasksBegin[t]].first;
+
+    for (unsigned int o = 0; o < OverlapsByTask[t].size(); o++)
+    {
+      lOverlaps.push_back(std::make_pair(Feats[i], Feats[OverlapsByTask[t][o]]));
+    }
   }
 
   return lOverlaps;
@@ -1084,7 +1816,8 @@ std::list<std::pair<OGRFeature*, OGRFeature*> > VectorDataset::findOverlap(unsig
 // =====================================================================
 
 
-std::list<std::pair<OGRFeature*,OGRFeature*> > VectorDataset::findGap(double Threshold, unsigned int LayerIndex)
+std::list<std::pair<OGRFeature*,OGRFeature*> > VectorDataset::findGap(double Threshold, unsigned int LayerIndex,
+                                                                      unsigned int ThreadsCount)
 {
   if ( ! isPolygonType(LayerIndex))
   {
@@ -1093,33 +1826,73 @@ std::list<std::pair<OGRFeature*,OGRFeature*> > VectorDataset::findGap(double Thr
 
   m_Features.clear();
   m_Geometries.clear();
+  m_Views.clear();
   std::list<std::pair<OGRFeature*,OGRFeature*> > lGaps;
   FeaturesList_t Features = features(LayerIndex);
 
+  std::vector<OGRFeature*> Feats;
+  std::vector<geos::geom::Geometry*> Geoms;
+
   for (FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
   {
-    FeaturesList_t FeaturesToTest = features(LayerIndex);
-    for (FeaturesList_t::iterator jt = FeaturesToTest.begin(); jt != FeaturesToTest.end(); ++jt)
+    Feats.push_back((*it).first);
+    Geoms.push_back((*it).second);
+  }
+
+  // only the geometries whose envelopes are closer than Threshold can be under the threshold
+  std::vector<std::pair<unsigned int, unsigned int> > Candidates = computeCandidatePairs(Geoms,Threshold);
+
+  // one task per range of candidates sharing the same first index
+  std::vector<unsigned int> TasksBegin = computeCandidateRanges(Candidates);
+
+  // each task writes only its own slot, no lock is needed
+  std::vector<std::vector<unsigned int> > GapsByTask(TasksBegin.size()-1);
+
+  openfluid::landr::LandRTools::runInParallel(GapsByTask.size(),[&](unsigned int t)
+  {
+    unsigned int i = Candidates[TasksBegin[t]].first;
+
+    std::unique_ptr<geos::geom::prep::PreparedGeometry> PreparedGeom(
+        geos::geom::prep::PreparedGeometryFactory::prepare(Geoms[i]));
+
+    int DimI = Geoms[i]->getDimension();
+
+    for (unsigned int c = TasksBegin[t]; c < TasksBegin[t+1]; c++)
     {
-      //test if Gap (under the threshold)
-      if (!(*it).first->GetGeometryRef()->Equals((*jt).first->GetGeometryRef()) &&
-          !(*it).first->GetGeometryRef()->Touches((*jt).first->GetGeometryRef()) &&
-          !(*it).first->GetGeometryRef()->Overlaps((*jt).first->GetGeometryRef()) &&
-          (*it).first->GetGeometryRef()->Distance((*jt).first->GetGeometryRef()) < Threshold)
+      unsigned int j = Candidates[c].second;
+
+      if (!PreparedGeom->intersects(Geoms[j]))
       {
-        std::list<std::pair<OGRFeature*,OGRFeature*>>::iterator lt;
-        std::list<std::pair<OGRFeature*,OGRFeature*>>::iterator lt2;
-        std::pair<OGRFeature*,OGRFeature*> pair1((*it).first, (*jt).first);
-        std::pair<OGRFeature*,OGRFeature*> pair2((*jt).first, (*it).first);
-
-        lt = std::find(lGaps.begin(), lGaps.end(), pair1);
-        lt2 = std::find (lGaps.begin(), lGaps.end(), pair2);
-        if (lt == lGaps.end() && lt2 == lGaps.end())
+        //test if Gap (under the threshold)
+        if (Geoms[i]->distance(Geoms[j]) < Threshold)
         {
-          lGaps.push_back(pair1);
+          GapsByTask[t].push_back(j);
+        }
+      }
+      else
+      {
+        // intersecting geometries are at distance 0:
+        // it is a gap unless they are equal, touching or overlapping, all given by a single relate
+        std::unique_ptr<geos::geom::IntersectionMatrix> Matrix = Geoms[i]->relate(Geoms[j]);
+        int DimJ = Geoms[j]->getDimension();
+
+        if (!Matrix->isEquals(DimI,DimJ) && !Matrix->isTouches(DimI,DimJ) && !Matrix->isOverlaps(DimI,DimJ) &&
+            Threshold > 0)
+        {
+          GapsByTask[t].push_back(j);
         }
       }
     }
+  },ThreadsCount);
+
+  for (unsigned int t = 0; t < GapsByTask.size(); t++)
+  {
+    unsigned int i = Candidates[TasksBegin[t]].first;
+
+    for (unsigned int g = 0; g < GapsByTask[t].size(); g++)
+    {
+      lGaps.push_back(std::make_pair(Feats[i], Feats[GapsByTask[t][g]]));
+    }
   }
 
   return lGaps;
@@ -1139,70 +1912,140 @@ void VectorDataset::cleanOverlap(double Threshold, unsigned int LayerIndex)
 
   m_Features.clear();
   m_Geometries.clear();
-  std::list<std::pair<OGRFeature*,OGRFeature*> > lOverlaps = findOverlap();
+  m_Views.clear();
+  FeaturesList_t Features = features(LayerIndex);
+
+  std::vector<OGRFeature*> Feats;
+  std::vector<geos::geom::Geometry*> Geoms;
 
-  int lSize=lOverlaps.size();
-  for (int i=0; i<lSize;i++)
+  for (FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
   {
-    // find the OGRFeature and the OGRGeometry in m_Features
-    OGRFeature *Feat1=lOverlaps.front().first;
-    OGRFeature *Feat2=lOverlaps.front().second;
+    Feats.push_back((*it).first);
+    Geoms.push_back((*it).second);
+  }
 
-    geos::geom::Geometry* Geom1 =
-        (geos::geom::Geometry*) openfluid::landr::convertOGRGeometryToGEOS(Feat1->GetGeometryRef());
-    geos::geom::Geometry* Geom2 =
-        (geos::geom::Geometry*) openfluid::landr::convertOGRGeometryToGEOS(Feat2->GetGeometryRef());
+  // cleaned geometries, replacing the parsed ones
+  std::vector<std::unique_ptr<geos::geom::Geometry> > Cleaned(Geoms.size());
 
-    geos::geom::Geometry * Diff= Geom1->difference(Geom2).release();
+  auto currentGeometry = [&Geoms,&Cleaned](unsigned int i)
+  {
+    return (Cleaned[i] ? Cleaned[i].get() : Geoms[i]);
+  };
 
-    // snap Diff with Geom2
-    geos::operation::overlay::snap::GeometrySnapper geomSnapper(*const_cast<geos::geom::Geometry*>(Geom2));
-    std::unique_ptr<geos::geom::Geometry> snapEntityGeom2=geomSnapper.snapTo(*Diff,Threshold);
+  // spatial index of the current geometries, updated each time a geometry is cleaned
+  std::vector<unsigned int> Ids(Geoms.size());
+  std::vector<geos::geom::Envelope> Envelopes(Geoms.size());
+  geos::index::quadtree::Quadtree Index;
 
-    geos::geom::Geometry* snappedEntityGeom2=snapEntityGeom2.release();
+  for (unsigned int i = 0; i < Geoms.size(); i++)
+  {
+    Ids[i] = i;
+    Envelopes[i] = *(Geoms[i]->getEnvelopeInternal());
+    Index.insert(&Envelopes[i],&Ids[i]);
+  }
 
-    OGRGeometry* OGRGeom1 = openfluid::landr::convertGEOSGeometryToOGR((GEOSGeom) Diff);
-    OGRGeometry* OGRGeom2 = openfluid::landr::convertGEOSGeometryToOGR((GEOSGeom) snappedEntityGeom2);
+  // pairs to process, in (first,second) order
+  std::set<std::pair<unsigned int, unsigned int> > Pending;
+  std::set<std::pair<unsigned int, unsigned int> > Processed;
 
+  std::vector<std::pair<unsigned int, unsigned int> > Candidates = computeCandidatePairs(Geoms);
+  Pending.insert(Candidates.begin(),Candidates.end());
 
-    Feat1->SetGeometry(OGRGeom1);
-    Feat2->SetGeometry(OGRGeom2);
+  while (!Pending.empty())
+  {
+    std::pair<unsigned int, unsigned int> Pair = *Pending.begin();
+    Pending.erase(Pending.begin());
+
+    // each pair is fixed at most once, so the cleaning always ends
+    if (!Processed.insert(Pair).second)
+    {
+      continue;
+    }
 
-    OGRFeature* Feat1Clone = Feat1->Clone();
-    OGRFeature* Feat2Clone = Feat2->Clone();
+    unsigned int i = Pair.first;
+    unsigned int j = Pair.second;
 
-    mp_DataSource->GetLayer(LayerIndex)->SetFeature(Feat1Clone);
-    mp_DataSource->GetLayer(LayerIndex)->SetFeature(Feat2Clone);
+    if (!currentGeometry(i)->overlaps(currentGeometry(j)))
+    {
+      continue;
+    }
 
-    OGRFeature::DestroyFeature(Feat1);
-    OGRFeature::DestroyFeature(Feat2);
+    std::unique_ptr<geos::geom::Geometry> Diff = currentGeometry(i)->difference(currentGeometry(j));
 
-    delete snappedEntityGeom2;
-    delete Diff;
-    delete Geom1;
-    delete Geom2;
+    // snap the second geometry with the difference
+    geos::operation::overlay::snap::GeometrySnapper geomSnapper(*currentGeometry(j));
+    std::unique_ptr<geos::geom::Geometry> Snapped = geomSnapper.snapTo(*Diff,Threshold);
 
-    // clean structures and find overlap
-    m_Features.clear();
-    m_Geometries.clear();
+    Cleaned[i] = std::move(Diff);
+    Cleaned[j] = std::move(Snapped);
 
-    try
+    // only the index entries of the two cleaned geometries are updated,
+    // then their new neighbours are queued
+    for (unsigned int k : {i,j})
     {
-      parse(LayerIndex);
+      Index.remove(&Envelopes[k],&Ids[k]);
+      Envelopes[k] = *(Cleaned[k]->getEnvelopeInternal());
+      Index.insert(&Envelopes[k],&Ids[k]);
+
+      std::vector<void*> Found;
+      Index.query(&Envelopes[k],Found);
+
+      for (void* Item : Found)
+      {
+        unsigned int n = *(static_cast<unsigned int*>(Item));
+
+        if (n != k && Envelopes[n].intersects(Envelopes[k]))
+        {
+          std::pair<unsigned int, unsigned int> NewPair = std::make_pair(std::min(n,k),std::max(n,k));
+
+          if (!Processed.count(NewPair))
+          {
+            Pending.insert(NewPair);
+          }
+        }
+      }
     }
-    catch (std::exception& e)
+  }
+
+  // all the cleaned features are written at once
+  WriteSessionGuard Session(this,1000,LayerIndex);
+
+  for (unsigned int i = 0; i < Feats.size(); i++)
+  {
+    if (!Cleaned[i])
     {
-      throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
-                                                "Unable to parse the VectorDataset ("  + std::string(e.what()) + ")");
+      continue;
     }
 
-    lOverlaps.clear();
-    lOverlaps=findOverlap();
+    OGRGeometry* OGRGeom = openfluid::landr::convertGEOSGeometryToOGR((GEOSGeom) Cleaned[i].get());
+    OGRFeature* FeatClone = Feats[i]->Clone();
+
+    FeatClone->SetGeometry(OGRGeom);
+    writeFeature(FeatClone);
+
+    OGRFeature::DestroyFeature(FeatClone);
+    delete OGRGeom;
   }
 
+  Session.commit();
+
+  m_Features.clear();
+  m_Geometries.clear();
+  m_Views.clear();
+
   try
   {
-    snapPolygonVertices(Threshold);
+    parse(LayerIndex);
+  }
+  catch (std::exception& e)
+  {
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,
+                                              "Unable to parse the VectorDataset ("  + std::string(e.what()) + ")");
+  }
+
+  try
+  {
+    snapPolygonVertices(Threshold,LayerIndex);
   }
   catch (std::exception& e)
   {
@@ -1221,23 +2064,61 @@ std::list<OGRFeature*> VectorDataset::hasDuplicateGeometry(unsigned int LayerInd
   std::list<OGRFeature*> lDuplicate;
   FeaturesList_t Features = features(LayerIndex);
 
+  std::vector<OGRFeature*> Feats;
+  std::vector<geos::geom::Geometry*> Geoms;
+  std::vector<std::unique_ptr<geos::geom::Geometry> > NormalizedGeoms;
+
+  // topologically equal geometries share the same envelope whatever their vertices order or redundant vertices,
+  // so the envelope of the normalized geometry is used as the bucket key
+  std::unordered_map<std::size_t, std::vector<unsigned int> > Buckets;
+
   for (FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
   {
-    geos::geom::Geometry* Geom = geometries();
-    unsigned int iEnd = Geom->getNumGeometries();
-    int DuplicateGeom = 0;
+    std::unique_ptr<geos::geom::Geometry> Normalized = (*it).second->clone();
+    Normalized->normalize();
+
+    const geos::geom::Envelope* Env = Normalized->getEnvelopeInternal();
+    std::hash<double> Hasher;
+    std::size_t Key = Hasher(Env->getMinX());
+    Key ^= Hasher(Env->getMinY()) + 0x9e3779b9 + (Key << 6) + (Key >> 2);
+    Key ^= Hasher(Env->getMaxX()) + 0x9e3779b9 + (Key << 6) + (Key >> 2);
+    Key ^= Hasher(Env->getMaxY()) + 0x9e3779b9 + (Key << 6) + (Key >> 2);
+
+    Buckets[Key].push_back(Geoms.size());
+
+    Feats.push_back((*it).first);
+    Geoms.push_back((*it).second);
+    NormalizedGeoms.push_back(std::move(Normalized));
+  }
+
+  std::vector<bool> IsDuplicate(Geoms.size(),false);
+
+  for (auto& Bucket : Buckets)
+  {
+    const std::vector<unsigned int>& Indexes = Bucket.second;
 
-    for (unsigned int i = 0; i < iEnd; i++)
+    for (unsigned int a = 0; a < Indexes.size(); a++)
     {
-      if ((const_cast<geos::geom::Geometry*>(Geom->getGeometryN(i)))->equals((*it).second))
+      for (unsigned int b = a+1; b < Indexes.size(); b++)
       {
-        DuplicateGeom++;
+        unsigned int i = Indexes[a];
+        unsigned int j = Indexes[b];
+
+        // identical normalized coordinates are enough, the full topological test is the fallback
+        if (NormalizedGeoms[i]->equalsExact(NormalizedGeoms[j].get()) || Geoms[i]->equals(Geoms[j]))
+        {
+          IsDuplicate[i] = true;
+          IsDuplicate[j] = true;
+        }
       }
     }
+  }
 
-    if (DuplicateGeom > 1)
+  for (unsigned int i = 0; i < Feats.size(); i++)
+  {
+    if (IsDuplicate[i])
     {
-      lDuplicate.push_back((*it).first);
+      lDuplicate.push_back(Feats[i]);
     }
   }
 
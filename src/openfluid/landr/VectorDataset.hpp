@@ -43,15 +43,20 @@
 #include <string>
 #include <map>
 #include <list>
+#include <vector>
+#include <memory>
+#include <functional>
 
 #include <ogrsf_frmts.h>
 
 #include <openfluid/dllexport.hpp>
 #include <openfluid/core/GeoVectorValue.hpp>
+#include <openfluid/landr/GeometriesView.hpp>
 
 
 namespace geos { namespace geom {
 class Geometry;
+class Coordinate;
 } }
 
 
@@ -70,6 +75,68 @@ class OPENFLUID_API VectorDataset
     */
     typedef std::list<std::pair<OGRFeature*, geos::geom::Geometry*> > FeaturesList_t;
 
+    /**
+      @brief A topology error found on a feature of this VectorDataset.
+    */
+    struct TopologyError
+    {
+      enum ErrorClass { INVALID_GEOMETRY, OVERLAP, GAP };
+
+      /**
+        @brief The FID of the feature in error.
+      */
+      GIntBig FID;
+
+      ErrorClass Class;
+
+      /**
+        @brief The coordinates of a location of the error.
+      */
+      double X, Y;
+
+      /**
+        @brief The FID of the offending neighbour feature, OGRNullFID for an invalid geometry.
+      */
+      GIntBig NeighbourFID;
+
+      /**
+        @brief The GEOS validation message for an invalid geometry, empty otherwise.
+      */
+      std::string Message;
+    };
+
+    /**
+      @brief A write session on a VectorDataset, rolled back if it is not committed when leaving its scope,
+      e.g. when an exception is thrown while writing.
+    */
+    class OPENFLUID_API WriteSessionGuard
+    {
+      private:
+
+        VectorDataset* mp_Vector;
+
+        bool m_IsClosed;
+
+      public:
+
+        /**
+          @brief Starts a write session on the given VectorDataset, see beginWriteSession().
+          @throw openfluid::base::FrameworkException if the session cannot be started.
+        */
+        WriteSessionGuard(VectorDataset* Vector, unsigned int BatchSize=1000, unsigned int LayerIndex=0);
+
+        /**
+          @brief Rolls back the session if it has not been committed.
+        */
+        ~WriteSessionGuard();
+
+        /**
+          @brief Commits the session, see commitWriteSession().
+          @throw openfluid::base::FrameworkException if the commit fails.
+        */
+        void commit();
+    };
+
   private:
 
     /**
@@ -88,6 +155,46 @@ class OPENFLUID_API VectorDataset
     */
     std::map<unsigned int, geos::geom::Geometry*> m_Geometries;
 
+    /**
+      @brief A map of views on the geometries of the layers of this VectorDataset, indexed by layer index.
+    */
+    std::map<unsigned int, std::unique_ptr<GeometriesView> > m_Views;
+
+    /**
+      @brief The layer written by the current write session, nullptr if no session is active.
+    */
+    OGRLayer* mp_WriteLayer;
+
+    /**
+      @brief The number of features written per transaction in the current write session.
+    */
+    unsigned int m_WriteBatchSize;
+
+    /**
+      @brief The number of features written since the last commit of the current write session.
+    */
+    unsigned int m_WrittenInBatch;
+
+    /**
+      @brief True if the current transaction is a dataset transaction, false if it is a layer transaction.
+    */
+    bool m_IsDatasetTransaction;
+
+    /**
+      @brief Starts a transaction on the dataset when supported, on the write layer otherwise.
+    */
+    void startWriteTransaction();
+
+    /**
+      @brief Commits the current transaction of the write session.
+    */
+    void commitWriteTransaction();
+
+    /**
+      @brief Rolls back the current transaction of the write session.
+    */
+    void rollbackWriteTransaction();
+
     /**
       @brief Returns the path of this VectorDataset associated with time.
     */
@@ -105,16 +212,78 @@ class OPENFLUID_API VectorDataset
     */
     bool isAlreadyExisting(const std::string& Path);
 
+    /**
+      @brief Creates the OGRDatasource of this VectorDataset as a copy of DS, then opens it for reading and writing.
+      @param DS The OGRDatasource to copy, which must be an ESRI Shapefile.
+      @param Copy The function writing the copy with the given driver at the given path,
+      returning the written OGRDatasource or nullptr if it can not be created.
+      @throw openfluid::base::FrameworkException if the driver of DS is not supported,
+      or if the copy can not be created or opened
+    */
+    void copySource(GDALDataset_COMPAT* DS,
+                    const std::function<GDALDataset_COMPAT*(GDALDriver_COMPAT*,const std::string&)>& Copy);
+
+    /**
+      @brief Creates the OGRDatasource of this VectorDataset as a filtered copy of DS.
+      @param DS The OGRDatasource to copy.
+      @param Clip The geometry the copied features must intersect, nullptr for no spatial filter.
+      @param AttributeFilter An OGR SQL WHERE clause restricting the copied features, empty for none.
+    */
+    void copyFilteredSource(GDALDataset_COMPAT* DS, OGRGeometry* Clip, const std::string& AttributeFilter);
+
     /**
       @brief Parse the geometry of this VectorDataset.
       @param LayerIndex The index layer.
     */
     void parse(unsigned int LayerIndex);
 
+    /**
+      @brief Snaps together the start and end points of the lines closer than or at a threshold,
+      in a single pass and a single write transaction.
+      @param Threshold The snapping threshold value.
+      @param LayerIndex The index layer.
+    */
     void snapLineNodes(double Threshold,unsigned int LayerIndex=0);
 
     void snapPolygonVertices(double Threshold,unsigned int LayerIndex=0);
 
+    /**
+      @brief Computes the pairs of geometries whose envelopes, expanded by Distance, intersect.
+      @details The envelopes are indexed in a geos::index::strtree::STRtree, so that the cost is close to
+      O(N log N) instead of O(N²). Each unordered pair is returned once as (i,j) with i < j,
+      sorted by i then j, i.e. following the order of Geoms.
+      @param Geoms The geometries to compare.
+      @param Distance The distance used to expand the envelopes, default 0.
+      @return A vector of pairs of indexes in Geoms.
+    */
+    static std::vector<std::pair<unsigned int, unsigned int> > computeCandidatePairs(
+        const std::vector<geos::geom::Geometry*>& Geoms, double Distance = 0);
+
+    /**
+      @brief Splits candidate pairs sorted by first index into ranges sharing the same first index,
+      so that each range can be processed by a single task preparing the first geometry once.
+      @param Candidates The pairs returned by computeCandidatePairs().
+      @return The position in Candidates of the beginning of each range, followed by the size of Candidates.
+    */
+    static std::vector<unsigned int> computeCandidateRanges(
+        const std::vector<std::pair<unsigned int, unsigned int> >& Candidates);
+
+    /**
+      @brief Snaps together the vertices of different owners which are closer than or at a threshold.
+      @details Coinciding vertices are grouped and never split. The positions are then visited from the most
+      shared one, the lowest in (x,y) order in case of tie, and each one is moved to the nearest representative
+      at most at the threshold which has no owner in common with it, or becomes a new representative. Representatives
+      never move and clusters do not merge transitively, so that a cluster never spreads beyond the threshold
+      and the result does not depend on the order of the vertices.
+      @param Coords The coordinates of the vertices, replaced by their snapped positions.
+      @param Owners The owner (e.g. feature index) of each vertex.
+      @param Threshold The snapping threshold value.
+      @return True if at least one vertex has moved, false otherwise.
+    */
+    static bool snapCoordinates(std::vector<geos::geom::Coordinate>& Coords,
+                                const std::vector<unsigned int>& Owners,
+                                double Threshold);
+
 
   public:
 
@@ -133,6 +302,28 @@ class OPENFLUID_API VectorDataset
     */
     VectorDataset(openfluid::core::GeoVectorValue& Value);
 
+    /**
+      @brief Creates in the openfluid temp directory a copy of the features of Value OGRDatasource
+      intersecting Extent, using the spatial filter of the driver so that only these features are decoded.
+      @param Value The GeoVectorValue to copy
+      @param Extent The extent of the features to copy.
+      @param AttributeFilter An OGR SQL WHERE clause restricting the features to copy, empty for none.
+      @throw openfluid::base::FrameworkException if fails.
+    */
+    VectorDataset(openfluid::core::GeoVectorValue& Value, const OGREnvelope& Extent,
+                  const std::string& AttributeFilter = "");
+
+    /**
+      @brief Creates in the openfluid temp directory a copy of the features of Value OGRDatasource
+      intersecting Clip, using the spatial filter of the driver so that only these features are decoded.
+      @param Value The GeoVectorValue to copy
+      @param Clip The geometry the features to copy must intersect.
+      @param AttributeFilter An OGR SQL WHERE clause restricting the features to copy, empty for none.
+      @throw openfluid::base::FrameworkException if fails.
+    */
+    VectorDataset(openfluid::core::GeoVectorValue& Value, OGRGeometry* Clip,
+                  const std::string& AttributeFilter = "");
+
     /**
       @brief Copy constructor.
       @throw openfluid::base::FrameworkException if fails.
@@ -266,11 +457,21 @@ class OPENFLUID_API VectorDataset
     /**
       @brief Gets a geos::geom::Geometry representing a collection of all
       the geometries of the layer LayerIndex of this GeoVectorValue.
+      The collection is built on first call only; prefer geometriesView() for indexed access or spatial predicates.
       @param LayerIndex The index of the layer to query, default 0.
       @return A geos::geom::Geometry.
     */
     geos::geom::Geometry* geometries(unsigned int LayerIndex = 0);
 
+    /**
+      @brief Gets a non-owning view on the geometries of the layer LayerIndex of this GeoVectorValue,
+      with indexed access and spatial predicates backed by a spatial index and prepared geometries.
+      The view is valid until the layer is modified or parsed again.
+      @param LayerIndex The index of the layer to query, default 0.
+      @return A GeometriesView.
+    */
+    const GeometriesView& geometriesView(unsigned int LayerIndex = 0);
+
     /**
       @brief Returns true if the VectorDataset is point type.
       @param LayerIndex The index of the layer to compare the type, default 0.
@@ -310,26 +511,73 @@ class OPENFLUID_API VectorDataset
      */
     std::string checkTopology(double Threshold, unsigned int LayerIndex=0);
 
+    /**
+      @brief Check the topology of this VectorDataset and returns one entry per error found.
+      Only for Polygon Type.
+      The validity of geometries, the overlaps and gaps search and the location of each error are computed
+      in parallel, each worker using its own GEOS context for the validity check.
+      Invalid geometries come first in layer order, followed by the overlaps then the gaps.
+      @param Threshold The maximum distance between polygon to be considered as gap.
+      @param LayerIndex The index of the layer to query, default 0.
+      @param ThreadsCount The number of threads to use, 0 for the number of hardware threads.
+      @return The list of errors, empty if the topology is correct.
+     */
+    std::vector<TopologyError> computeTopologyReport(double Threshold, unsigned int LayerIndex=0,
+                                                     unsigned int ThreadsCount=0);
+
+    /**
+      @brief Starts a write session on a layer of this VectorDataset.
+      Features written with writeFeature() are committed in transactions of BatchSize features,
+      which avoids one commit per feature on transactional formats such as GeoPackage.
+      @param BatchSize The number of features per transaction, default 1000.
+      @param LayerIndex The index of the layer to write, default 0.
+     */
+    void beginWriteSession(unsigned int BatchSize=1000, unsigned int LayerIndex=0);
+
+    /**
+      @brief Rewrites an existing feature in the current write session.
+      @param Feature The feature to write, unchanged and still owned by the caller.
+     */
+    void writeFeature(OGRFeature* Feature);
+
+    /**
+      @brief Commits the pending features and ends the current write session.
+     */
+    void commitWriteSession();
+
+    /**
+      @brief Discards the features written since the last commit and ends the current write session.
+      Batches already committed during the session are kept.
+      @throw openfluid::base::FrameworkException if no write session is active or if the rollback fails.
+     */
+    void rollbackWriteSession();
+
     /**
       @brief Find the overlapping polygons.
       Only for Polygon Type;
       @param LayerIndex The index of the layer to query, default 0.
+      @param ThreadsCount The number of threads to use, 0 for the number of hardware threads.
       @return A list of pair of OGRFeature* for each overlap between two polygons.
      */
-    std::list<std::pair<OGRFeature*, OGRFeature*> > findOverlap(unsigned int LayerIndex=0);
+    std::list<std::pair<OGRFeature*, OGRFeature*> > findOverlap(unsigned int LayerIndex=0,
+                                                                unsigned int ThreadsCount=0);
 
     /**
       @brief Find gap between polygons.
       Only for Polygon Type;
       @param Threshold The maximum distance between polygon to be considered as gap.
       @param LayerIndex The index of the layer to query, default 0.
+      @param ThreadsCount The number of threads to use, 0 for the number of hardware threads.
       @return A list of pair of OGRFeature* for each overlap between two polygons.
      */
-    std::list<std::pair<OGRFeature*, OGRFeature*> > findGap(double Threshold,unsigned int LayerIndex=0);
+    std::list<std::pair<OGRFeature*, OGRFeature*> > findGap(double Threshold,unsigned int LayerIndex=0,
+                                                            unsigned int ThreadsCount=0);
 
     /**
       @brief Clean the overlapping polygons.
       Only for Polygon Type;
+      All the overlaps are computed once and resolved in (first,second) feature order, each pair at most once,
+      and the cleaned features are written in a single batch.
       @param Threshold The snapping threshold value.
       @param LayerIndex The index of the layer to query, default 0.
      */
@@ -47,6 +47,8 @@
 
 #include <geos/geom/LineString.h>
 #include <geos/geom/CoordinateSequence.h>
+#include <geos/geom/Envelope.h>
+#include <geos/index/strtree/STRtree.h>
 
 #include <openfluid/base/FrameworkException.hpp>
 #include <openfluid/base/Environment.hpp>
@@ -247,6 +249,40 @@ BOOST_AUTO_TEST_CASE(check_getRasterPolygonizedMultiPoly)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_getRasterPolygonizedPolysIndex)
+{
+  openfluid::core::GeoVectorValue* Vector =
+    new openfluid::core::GeoVectorValue(CONFIGTESTS_DATA_INPUT_DIR+ "/landr", "SU.shp");
+
+  openfluid::core::GeoRasterValue* Raster =
+    new openfluid::core::GeoRasterValue(CONFIGTESTS_DATA_INPUT_DIR +"/GeoRasterValue", "dem.jpeg");
+
+  openfluid::landr::PolygonGraph* Graph = openfluid::landr::PolygonGraph::create(*Vector);
+
+  BOOST_CHECK_THROW(Graph->rasterPolygonizedPolysIndex(),openfluid::base::FrameworkException);
+
+  Graph->addAGeoRasterValue(*Raster);
+
+  geos::index::strtree::STRtree* Index = Graph->rasterPolygonizedPolysIndex();
+  BOOST_CHECK_EQUAL(Index,Graph->rasterPolygonizedPolysIndex());
+
+  OGREnvelope RasterEnvelope = openfluid::landr::RasterDataset(*Raster).envelope();
+  geos::geom::Envelope QueryEnvelope(RasterEnvelope.MinX,RasterEnvelope.MaxX,RasterEnvelope.MinY,RasterEnvelope.MaxY);
+
+  std::vector<void*> Found;
+  Index->query(&QueryEnvelope,Found);
+  BOOST_CHECK_EQUAL(Found.size(), 234);
+
+  delete Graph;
+  delete Vector;
+  delete Raster;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_get_AVectorAttribute_from_Id_for_LineStringGraph)
 {
   openfluid::core::GeoVectorValue* Vector =
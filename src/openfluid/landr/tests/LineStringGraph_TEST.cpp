@@ -44,9 +44,13 @@
 
 
 #include <algorithm>
+#include <cmath>
+#include <fstream>
 
 #include <boost/test/unit_test.hpp>
 
+#include <cpl_vsi.h>
+
 #include <geos/planargraph/DirectedEdge.h>
 #include <geos/planargraph/Node.h>
 #include <geos/geom/CoordinateSequence.h>
@@ -526,6 +530,48 @@ BOOST_AUTO_TEST_CASE(check_setAttributeFromRasterValueAtEndNode_float64PixelType
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_setAttributeFromRasterValueAtNodes_interpolated)
+{
+  openfluid::core::GeoVectorValue* Vector =
+    new openfluid::core::GeoVectorValue(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "RS.shp");
+
+  openfluid::core::GeoRasterValue* Raster =
+    new openfluid::core::GeoRasterValue(CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue", "dem.jpeg");
+
+  openfluid::landr::LineStringGraph* Graph = openfluid::landr::LineStringGraph::create(*Vector);
+
+  Graph->addAGeoRasterValue(*Raster);
+
+  Graph->setAttributeFromRasterValueAtStartNode("start_val");
+  Graph->setAttributeFromRasterValueAtStartNode("start_nearest",openfluid::landr::RasterDataset::NEAREST);
+  Graph->setAttributeFromRasterValueAtStartNode("start_bilinear",openfluid::landr::RasterDataset::BILINEAR);
+  Graph->setAttributeFromRasterValueAtEndNode("end_bicubic",openfluid::landr::RasterDataset::BICUBIC);
+
+  openfluid::core::DoubleValue Val, NearestVal, BilinearVal, BicubicVal;
+
+  for (auto Entity : Graph->getEntities())
+  {
+    Entity->getAttributeValue("start_val", Val);
+    Entity->getAttributeValue("start_nearest", NearestVal);
+    BOOST_CHECK_EQUAL(Val.get(), NearestVal.get());
+
+    BOOST_CHECK(Entity->getAttributeValue("start_bilinear", BilinearVal));
+    BOOST_CHECK(!std::isnan(BilinearVal.get()));
+
+    BOOST_CHECK(Entity->getAttributeValue("end_bicubic", BicubicVal));
+    BOOST_CHECK(!std::isnan(BicubicVal.get()));
+  }
+
+  delete Graph;
+  delete Vector;
+  delete Raster;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_setAttributeFromRasterValueAtCentroid_intPixelType)
 {
   openfluid::core::GeoVectorValue* Vector =
@@ -803,6 +849,112 @@ BOOST_AUTO_TEST_CASE(check_setAttributeFromMeanRasterValues_float64PixelType)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_computeRasterProfiles)
+{
+  openfluid::core::GeoVectorValue* Vector =
+    new openfluid::core::GeoVectorValue(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "RS.shp");
+
+  openfluid::core::GeoRasterValue* Raster =
+    new openfluid::core::GeoRasterValue(CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue", "dem.jpeg");
+
+  openfluid::landr::LineStringGraph* Graph = openfluid::landr::LineStringGraph::create(*Vector);
+
+  BOOST_CHECK_THROW(Graph->computeRasterProfiles(),openfluid::base::FrameworkException);
+
+  Graph->addAGeoRasterValue(*Raster);
+
+  std::vector<openfluid::landr::LineStringGraph::RasterProfile> Profiles = Graph->computeRasterProfiles();
+
+  BOOST_CHECK_EQUAL(Profiles.size(),Graph->getSize());
+
+  for (const openfluid::landr::LineStringGraph::RasterProfile& Profile : Profiles)
+  {
+    BOOST_CHECK(Profile.Count > 1);
+    BOOST_CHECK(Profile.Min <= Profile.Mean && Profile.Mean <= Profile.Max);
+    BOOST_CHECK(Profile.MaxSlope >= std::fabs(Profile.Slope) - 1e-9);
+  }
+
+  Graph->setAttributeFromRasterProfile("max_val",openfluid::landr::LineStringGraph::RasterProfile::MAX);
+  Graph->setAttributeFromRasterValueAtStartNode("start_val");
+
+  openfluid::core::DoubleValue MaxVal, StartVal;
+
+  for (auto Entity : Graph->getEntities())
+  {
+    Entity->getAttributeValue("max_val", MaxVal);
+    Entity->getAttributeValue("start_val", StartVal);
+    BOOST_CHECK(StartVal.get() <= MaxVal.get());
+  }
+
+  delete Graph;
+  delete Vector;
+  delete Raster;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_computeRasterProfiles_outOfExtent)
+{
+  const std::string OutputPath = CONFIGTESTS_DATA_OUTPUT_DIR + "/RasterProfiles";
+  VSIMkdir(OutputPath.c_str(),0755);
+
+  // 10x10 raster of 1x1 pixels from (0,0), the values of each row are the row index
+  std::ofstream RasterFile(OutputPath + "/rows.asc");
+  RasterFile << "ncols 10\nnrows 10\nxllcorner 0\nyllcorner 0\ncellsize 1\n";
+  for (unsigned int r = 0; r < 10; r++)
+  {
+    for (unsigned int c = 0; c < 10; c++)
+    {
+      RasterFile << r << " ";
+    }
+    RasterFile << "\n";
+  }
+  RasterFile.close();
+
+  openfluid::core::GeoRasterValue Raster(OutputPath, "rows.asc");
+
+  // a line leaving the raster along row 5 and coming back along row 2
+  openfluid::landr::VectorDataset* Vect = new openfluid::landr::VectorDataset("profile.shp");
+  Vect->addALayer("profile",wkbLineString);
+  Vect->addAField("OFLD_ID",OFTInteger);
+
+  OGRLineString* Line = new OGRLineString();
+  Line->addPoint(5.5,4.5);
+  Line->addPoint(-4.5,4.5);
+  Line->addPoint(-4.5,7.5);
+  Line->addPoint(2.5,7.5);
+
+  OGRFeature* Feat = OGRFeature::CreateFeature(Vect->layerDef());
+  Feat->SetField("OFLD_ID",1);
+  Feat->SetGeometryDirectly(Line);
+  BOOST_REQUIRE_EQUAL(Vect->layer()->CreateFeature(Feat),OGRERR_NONE);
+  OGRFeature::DestroyFeature(Feat);
+
+  openfluid::landr::LineStringGraph* Graph = openfluid::landr::LineStringGraph::create(*Vect);
+  Graph->addAGeoRasterValue(Raster);
+
+  std::vector<openfluid::landr::LineStringGraph::RasterProfile> Profiles = Graph->computeRasterProfiles();
+  BOOST_REQUIRE_EQUAL(Profiles.size(),1);
+
+  // 6 samples on 5 length units of row 5, 3 samples on 2 length units of row 2,
+  // the part of the line outside of the raster has no weight
+  BOOST_CHECK_EQUAL(Profiles[0].Count,9);
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Profiles[0].Min,2.0));
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Profiles[0].Max,5.0));
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Profiles[0].Mean,29.0/7));
+
+  delete Graph;
+  delete Vect;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_mergedLineStringEntity)
 {
   openfluid::core::GeoVectorValue* Val =
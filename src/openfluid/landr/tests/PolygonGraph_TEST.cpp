@@ -45,6 +45,11 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <vector>
+
+#include <gdal_priv.h>
+#include <cpl_vsi.h>
+
 #include <geos/geom/Geometry.h>
 #include <geos/geom/LineString.h>
 #include <geos/geom/Polygon.h>
@@ -107,6 +112,48 @@ BOOST_AUTO_TEST_CASE(check_construction_fromGeovectorValue)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_construction_fromFilteredGeovectorValue)
+{
+  openfluid::core::GeoVectorValue* Val =
+    new openfluid::core::GeoVectorValue(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "SU.shp");
+
+  openfluid::landr::VectorDataset* Vect = new openfluid::landr::VectorDataset(*Val);
+  OGREnvelope Extent = Vect->envelope();
+  delete Vect;
+
+  openfluid::landr::PolygonGraph* Graph = openfluid::landr::PolygonGraph::create(*Val,Extent);
+  BOOST_CHECK_EQUAL(Graph->getSize(), 24);
+  delete Graph;
+
+  Graph = openfluid::landr::PolygonGraph::create(*Val,Extent,"OFLD_ID <= 5");
+  BOOST_CHECK_EQUAL(Graph->getSize(), 5);
+  delete Graph;
+
+  // the lower left quarter of the layer
+  OGREnvelope Quarter = Extent;
+  Quarter.MaxX = (Extent.MinX + Extent.MaxX) / 2;
+  Quarter.MaxY = (Extent.MinY + Extent.MaxY) / 2;
+
+  Graph = openfluid::landr::PolygonGraph::create(*Val,Quarter);
+  BOOST_CHECK(Graph->getSize() > 0);
+  BOOST_CHECK(Graph->getSize() < 24);
+  delete Graph;
+
+  BOOST_CHECK_THROW(openfluid::landr::PolygonGraph::create(*Val,Quarter,"WRONG_FIELD = 1"),
+                    openfluid::base::FrameworkException);
+
+  // the shared source is left without any filter
+  BOOST_CHECK(Val->data()->GetLayer(0)->GetSpatialFilter() == nullptr);
+  BOOST_CHECK_EQUAL(Val->data()->GetLayer(0)->GetFeatureCount(), 24);
+
+  delete Val;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_construction_fromEntityVector)
 {
   openfluid::core::GeoVectorValue Val(CONFIGTESTS_DATA_INPUT_DIR + "/landr/","SU.shp");
@@ -908,6 +955,200 @@ BOOST_AUTO_TEST_CASE(check_setAttributeFromMeanRasterValues_float64PixelType)
   Graph->entity(2)->getAttributeValue("test_val", Val);
   BOOST_CHECK( openfluid::scientific::isVeryClose(Val.get(), 46.8027));
 
+  // same values with worker threads
+  Graph->setAttributeFromMeanRasterValues("test_val_mt",4);
+
+  openfluid::core::DoubleValue MTVal;
+
+  for (auto Entity : Graph->getEntities())
+  {
+    BOOST_CHECK_EQUAL(Entity->getAttributeValue("test_val", Val),Entity->getAttributeValue("test_val_mt", MTVal));
+    BOOST_CHECK_EQUAL(Val.get(),MTVal.get());
+  }
+
+  delete Graph;
+  delete Vector;
+  delete Raster;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_setAttributeFromRasterStatistics)
+{
+  openfluid::core::GeoVectorValue* Vector =
+    new openfluid::core::GeoVectorValue(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "SU.shp");
+
+  openfluid::core::GeoRasterValue* Raster =
+    new openfluid::core::GeoRasterValue(CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue", "dem.asc");
+
+  openfluid::landr::PolygonGraph* Graph = openfluid::landr::PolygonGraph::create(*Vector);
+
+  BOOST_CHECK_THROW(Graph->setAttributeFromRasterStatistics("mean_val",
+                                                            openfluid::landr::RasterDataset::ZonalStatistics::MEAN),
+                    openfluid::base::FrameworkException);
+
+  Graph->addAGeoRasterValue(*Raster);
+
+  Graph->setAttributeFromRasterStatistics("mean_val", openfluid::landr::RasterDataset::ZonalStatistics::MEAN);
+  Graph->setAttributeFromRasterStatistics("min_val", openfluid::landr::RasterDataset::ZonalStatistics::MIN);
+  Graph->setAttributeFromRasterStatistics("max_val", openfluid::landr::RasterDataset::ZonalStatistics::MAX);
+  Graph->setAttributeFromRasterStatistics("std_val", openfluid::landr::RasterDataset::ZonalStatistics::STDDEV);
+
+  openfluid::core::DoubleValue Mean, Min, Max, StdDev;
+
+  for (unsigned int i = 1; i <= 2; i++)
+  {
+    Graph->entity(i)->getAttributeValue("mean_val", Mean);
+    Graph->entity(i)->getAttributeValue("min_val", Min);
+    Graph->entity(i)->getAttributeValue("max_val", Max);
+    Graph->entity(i)->getAttributeValue("std_val", StdDev);
+
+    BOOST_CHECK(Min.get() <= Mean.get() && Mean.get() <= Max.get());
+    BOOST_CHECK(StdDev.get() >= 0);
+  }
+
+  delete Graph;
+  delete Vector;
+  delete Raster;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_setAttributeFromRasterStatistics_parallel)
+{
+  openfluid::core::GeoVectorValue* Vector =
+    new openfluid::core::GeoVectorValue(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "SU.shp");
+
+  openfluid::core::GeoRasterValue* Raster =
+    new openfluid::core::GeoRasterValue(CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue", "dem.asc");
+
+  openfluid::landr::PolygonGraph* Graph = openfluid::landr::PolygonGraph::create(*Vector);
+
+  Graph->addAGeoRasterValue(*Raster);
+
+  Graph->setAttributeFromRasterStatistics("serial_val", openfluid::landr::RasterDataset::ZonalStatistics::MEAN,
+                                          true, 1);
+  Graph->setAttributeFromRasterStatistics("parallel_val", openfluid::landr::RasterDataset::ZonalStatistics::MEAN,
+                                          true, 4);
+
+  openfluid::core::DoubleValue SerialVal, ParallelVal;
+
+  for (auto Entity : Graph->getEntities())
+  {
+    BOOST_CHECK_EQUAL(Entity->getAttributeValue("serial_val", SerialVal),
+                      Entity->getAttributeValue("parallel_val", ParallelVal));
+    BOOST_CHECK_EQUAL(SerialVal.get(),ParallelVal.get());
+  }
+
+  delete Graph;
+  delete Vector;
+  delete Raster;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_setAttributeFromRasterStatistics_multiBands)
+{
+  // two bands raster, the second band being the first one shifted by 100
+  const std::string OutputPath = CONFIGTESTS_DATA_OUTPUT_DIR + "/landr";
+  VSIMkdir(OutputPath.c_str(),0755);
+
+  GDALAllRegister();
+
+  GDALDataset* Dem =
+      static_cast<GDALDataset*>(GDALOpen((CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue/dem.asc").c_str(),
+                                         GA_ReadOnly));
+  BOOST_REQUIRE(Dem);
+
+  const int XSize = Dem->GetRasterXSize();
+  const int YSize = Dem->GetRasterYSize();
+
+  GDALDataset* TwoBands =
+      GetGDALDriverManager()->GetDriverByName("GTiff")->Create((OutputPath + "/dem2bands.tif").c_str(),
+                                                               XSize,YSize,2,GDT_Float64,nullptr);
+  BOOST_REQUIRE(TwoBands);
+
+  double GeoTransform[6];
+  Dem->GetGeoTransform(GeoTransform);
+  TwoBands->SetGeoTransform(GeoTransform);
+  TwoBands->SetProjection(Dem->GetProjectionRef());
+
+  std::vector<double> Values(XSize * YSize);
+  BOOST_REQUIRE_EQUAL(Dem->GetRasterBand(1)->RasterIO(GF_Read,0,0,XSize,YSize,Values.data(),XSize,YSize,
+                                                      GDT_Float64,0,0),CE_None);
+  BOOST_REQUIRE_EQUAL(TwoBands->GetRasterBand(1)->RasterIO(GF_Write,0,0,XSize,YSize,Values.data(),XSize,YSize,
+                                                           GDT_Float64,0,0),CE_None);
+
+  for (double& Value : Values)
+  {
+    Value += 100;
+  }
+
+  BOOST_REQUIRE_EQUAL(TwoBands->GetRasterBand(2)->RasterIO(GF_Write,0,0,XSize,YSize,Values.data(),XSize,YSize,
+                                                           GDT_Float64,0,0),CE_None);
+
+  GDALClose(TwoBands);
+  GDALClose(Dem);
+
+  openfluid::core::GeoVectorValue* Vector =
+    new openfluid::core::GeoVectorValue(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "SU.shp");
+
+  openfluid::core::GeoRasterValue* Raster =
+    new openfluid::core::GeoRasterValue(OutputPath, "dem2bands.tif");
+
+  openfluid::landr::PolygonGraph* Graph = openfluid::landr::PolygonGraph::create(*Vector);
+
+  Graph->addAGeoRasterValue(*Raster);
+
+  BOOST_CHECK_THROW(Graph->setAttributeFromRasterStatistics(std::vector<std::string>{"a_val"},
+                                                            openfluid::landr::RasterDataset::ZonalStatistics::MEAN,
+                                                            std::vector<unsigned int>{1,2}),
+                    openfluid::base::FrameworkException);
+
+  Graph->setAttributeFromRasterStatistics("single_val", openfluid::landr::RasterDataset::ZonalStatistics::MEAN);
+  Graph->setAttributeFromRasterStatistics(std::vector<std::string>{"band2_val","band1_val"},
+                                          openfluid::landr::RasterDataset::ZonalStatistics::MEAN,
+                                          std::vector<unsigned int>{2,1});
+  Graph->setAttributeFromRasterStatistics(std::vector<std::string>{"max1_val","max2_val"},
+                                          openfluid::landr::RasterDataset::ZonalStatistics::MAX,
+                                          std::vector<unsigned int>{1,2});
+
+  openfluid::core::DoubleValue SingleVal, Band1Val, Band2Val, Max1Val, Max2Val;
+  unsigned int ValuedCount = 0;
+
+  for (auto Entity : Graph->getEntities())
+  {
+    bool HasValue = Entity->getAttributeValue("single_val", SingleVal);
+
+    BOOST_CHECK_EQUAL(HasValue,Entity->getAttributeValue("band1_val", Band1Val));
+    BOOST_CHECK_EQUAL(HasValue,Entity->getAttributeValue("band2_val", Band2Val));
+    BOOST_CHECK_EQUAL(HasValue,Entity->getAttributeValue("max1_val", Max1Val));
+    BOOST_CHECK_EQUAL(HasValue,Entity->getAttributeValue("max2_val", Max2Val));
+
+    if (!HasValue)
+    {
+      continue;
+    }
+
+    ValuedCount++;
+
+    BOOST_CHECK_CLOSE(SingleVal.get(),Band1Val.get(),0.0001);
+    BOOST_CHECK_CLOSE(Band2Val.get(),Band1Val.get() + 100,0.0001);
+    BOOST_CHECK_CLOSE(Max2Val.get(),Max1Val.get() + 100,0.0001);
+    BOOST_CHECK_GE(Max1Val.get(),Band1Val.get());
+  }
+
+  BOOST_CHECK(ValuedCount > 0);
+
   delete Graph;
   delete Vector;
   delete Raster;
@@ -2418,8 +2659,9 @@ BOOST_AUTO_TEST_CASE(check_setAttributeFromMeanRasterValues_With_NoData)
 
   openfluid::core::DoubleValue Val;
 
+  // the mean is computed over the valid pixels only, the nodata pixels are left out
   Graph->entity(1)->getAttributeValue("test_val", Val);
-  BOOST_CHECK( openfluid::scientific::isVeryClose(Val.get(), 76.7213));
+  BOOST_CHECK( openfluid::scientific::isVeryClose(Val.get(), 76.72219));
 
   delete Graph;
   delete Vector;
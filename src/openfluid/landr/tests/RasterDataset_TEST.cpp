@@ -45,7 +45,21 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <cmath>
+#include <map>
+#include <cstdint>
+#include <memory>
+#include <algorithm>
+#include <fstream>
+
+#include <cpl_conv.h>
+#include <cpl_vsi.h>
+#include <cpl_virtualmem.h>
+
 #include <geos/geom/Coordinate.h>
+#include <geos/geom/Envelope.h>
+#include <geos/geom/Geometry.h>
+#include <geos/geom/GeometryFactory.h>
 
 #include <openfluid/base/FrameworkException.hpp>
 #include <openfluid/base/Environment.hpp>
@@ -202,6 +216,204 @@ BOOST_AUTO_TEST_CASE(check_getValues)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_getValues_buffers)
+{
+  openfluid::core::GeoRasterValue Val(CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue", "dem.jpeg");
+
+  openfluid::landr::RasterDataset* Rast = new openfluid::landr::RasterDataset(Val);
+
+  int XSize = Rast->rasterBand(1)->GetXSize();
+  int YSize = Rast->rasterBand(1)->GetYSize();
+
+  std::vector<float> Line(XSize);
+  std::vector<float> Column(YSize);
+
+  for (int l = 0; l < YSize; l++)
+  {
+    Rast->getValuesOfLine(l,Line.data());
+
+    for (int c = 0; c < XSize; c++)
+    {
+      BOOST_CHECK_EQUAL(Line[c],Rast->getValueOfPixel(c,l));
+    }
+  }
+
+  // columns swept from a strip, then with budgets of three columns and of a single column per strip
+  for (std::size_t Budget : {std::size_t(64*1024*1024), 3 * YSize * sizeof(float), sizeof(float)})
+  {
+    Rast->setCacheMemoryBudget(Budget);
+    Rast->clearCache();
+
+    for (int c = XSize - 1; c >= 0; c--)
+    {
+      Rast->getValuesOfColumn(c,Column.data());
+
+      for (int l = 0; l < YSize; l++)
+      {
+        BOOST_CHECK_EQUAL(Column[l],Rast->getValueOfPixel(c,l));
+      }
+    }
+  }
+
+  BOOST_CHECK_THROW(Rast->getValuesOfLine(YSize,Line.data()),openfluid::base::FrameworkException);
+  BOOST_CHECK_THROW(Rast->getValuesOfColumn(-1,Column.data()),openfluid::base::FrameworkException);
+
+  delete Rast;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_getValues_cache)
+{
+  openfluid::core::GeoRasterValue Val(CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue", "dem.asc");
+
+  openfluid::landr::RasterDataset* Rast = new openfluid::landr::RasterDataset(Val);
+
+  int XSize = Rast->rasterBand(1)->GetXSize();
+  int YSize = Rast->rasterBand(1)->GetYSize();
+
+  // a budget smaller than a tile forces an eviction on each new tile
+  for (std::size_t Budget : {std::size_t(1),std::size_t(64*1024*1024)})
+  {
+    Rast->clearCache();
+    Rast->setCacheMemoryBudget(Budget);
+    BOOST_CHECK_EQUAL(Rast->getCacheMemoryBudget(),Budget);
+
+    for (int l = YSize - 1; l >= 0; l--)
+    {
+      std::vector<float> Line = Rast->getValuesOfLine(l);
+
+      for (int c = 0; c < XSize; c++)
+      {
+        BOOST_CHECK_EQUAL(Rast->getValueOfPixel(c,l),Line[c]);
+      }
+    }
+  }
+
+  BOOST_CHECK_THROW(Rast->getValueOfPixel(-1,0),openfluid::base::FrameworkException);
+  BOOST_CHECK_THROW(Rast->getValueOfPixel(0,YSize),openfluid::base::FrameworkException);
+  BOOST_CHECK_THROW(Rast->getValueOfPixel(XSize,0),openfluid::base::FrameworkException);
+
+  delete Rast;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_loadInMemory)
+{
+  openfluid::core::GeoRasterValue Val(CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue", "dem.asc");
+
+  openfluid::landr::RasterDataset* Rast = new openfluid::landr::RasterDataset(Val);
+
+  int XSize = Rast->rasterBand(1)->GetXSize();
+  int YSize = Rast->rasterBand(1)->GetYSize();
+
+  std::vector<float> Expected;
+  for (int l = 0; l < YSize; l++)
+  {
+    for (int c = 0; c < XSize; c++)
+    {
+      Expected.push_back(Rast->getValueOfPixel(c,l));
+    }
+  }
+
+  BOOST_CHECK(!Rast->isLoadedInMemory());
+  BOOST_CHECK_THROW(Rast->inMemoryBuffer<float>(),openfluid::base::FrameworkException);
+
+  Rast->loadInMemory();
+
+  BOOST_CHECK(Rast->isLoadedInMemory());
+  BOOST_CHECK_THROW(Rast->inMemoryBuffer<double>(),openfluid::base::FrameworkException);
+
+  for (int l = 0; l < YSize; l++)
+  {
+    openfluid::landr::RasterDataset::BandView<float> Line = Rast->lineView<float>(l);
+    BOOST_CHECK_EQUAL(Line.size(),XSize);
+
+    for (int c = 0; c < XSize; c++)
+    {
+      BOOST_CHECK_EQUAL(Line[c],Expected[l*XSize+c]);
+      BOOST_CHECK_EQUAL(Rast->inMemoryPixel<float>(c,l),Expected[l*XSize+c]);
+      BOOST_CHECK_EQUAL(Rast->getValueOfPixel(c,l),Expected[l*XSize+c]);
+    }
+  }
+
+  openfluid::landr::RasterDataset::BandView<float> Column = Rast->columnView<float>(XSize-1);
+  BOOST_CHECK_EQUAL(Column.size(),YSize);
+  BOOST_CHECK_EQUAL(Column.at(YSize-1),Expected.back());
+  BOOST_CHECK_THROW(Column.at(YSize),openfluid::base::FrameworkException);
+  BOOST_CHECK_THROW(Rast->inMemoryPixelAt<float>(XSize,0),openfluid::base::FrameworkException);
+
+  std::vector<float> Line = Rast->getValuesOfLine(1);
+  BOOST_CHECK(std::equal(Line.begin(),Line.end(),Expected.begin()+XSize));
+
+  // loaded as integers, values are rounded to the nearest integer
+  Rast->loadInMemory(1,openfluid::landr::RasterDataset::INT16);
+  BOOST_CHECK_EQUAL(Rast->inMemoryPixelAt<std::int16_t>(0,0),std::int16_t(std::lround(Expected[0])));
+
+  Rast->unloadFromMemory();
+  BOOST_CHECK(!Rast->isLoadedInMemory());
+  BOOST_CHECK_EQUAL(Rast->getValueOfPixel(0,0),Expected[0]);
+
+  delete Rast;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_memoryMapping)
+{
+  // compressed formats are read through GDAL
+  openfluid::core::GeoRasterValue JpegVal(CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue", "dem.jpeg");
+  openfluid::landr::RasterDataset JpegRast(JpegVal);
+  BOOST_CHECK(!JpegRast.isMemoryMapped());
+
+  openfluid::core::GeoRasterValue Val(CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue", "dem.Gtiff");
+
+  // uncompressed single strip GeoTIFF, mapped wherever the platform supports file mapping
+  openfluid::landr::RasterDataset Mapped(Val);
+  if (CPLIsVirtualMemFileMapAvailable())
+  {
+    BOOST_CHECK(Mapped.isMemoryMapped());
+  }
+
+  openfluid::landr::RasterDataset NotMapped(Val);
+  NotMapped.setMemoryMappingEnabled(false);
+  BOOST_CHECK(!NotMapped.isMemoryMapped());
+
+  int XSize = Mapped.rasterBand(1)->GetXSize();
+  int YSize = Mapped.rasterBand(1)->GetYSize();
+
+  for (int l = 0; l < YSize; l++)
+  {
+    for (int c = 0; c < XSize; c++)
+    {
+      BOOST_CHECK_EQUAL(Mapped.getValueOfPixel(c,l),NotMapped.getValueOfPixel(c,l));
+    }
+  }
+
+  std::vector<float> MappedColumn = Mapped.getValuesOfColumn(XSize-1);
+  std::vector<float> NotMappedColumn = NotMapped.getValuesOfColumn(XSize-1);
+  BOOST_CHECK(MappedColumn == NotMappedColumn);
+
+  // copies share the mapping
+  openfluid::landr::RasterDataset MappedCopy(Mapped);
+  BOOST_CHECK_EQUAL(MappedCopy.isMemoryMapped(),Mapped.isMemoryMapped());
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_getValueOfCoordinate)
 {
   // integer values
@@ -237,6 +449,336 @@ BOOST_AUTO_TEST_CASE(check_getValueOfCoordinate)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_getValuesOfCoordinates)
+{
+  openfluid::core::GeoRasterValue Val(CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue", "dem.asc");
+
+  openfluid::landr::RasterDataset* Rast = new openfluid::landr::RasterDataset(Val);
+
+  geos::geom::Coordinate* Origin = Rast->computeOrigin();
+  int XSize = Rast->rasterBand(1)->GetXSize();
+  int YSize = Rast->rasterBand(1)->GetYSize();
+
+  // pixel centers, from the last pixel to the first one, so that tiles are not visited in order
+  std::vector<geos::geom::Coordinate> Coords;
+  for (int l = YSize - 1; l >= 0; l--)
+  {
+    for (int c = XSize - 1; c >= 0; c--)
+    {
+      Coords.push_back(geos::geom::Coordinate(Origin->x + (c + 0.5) * Rast->getPixelWidth(),
+                                              Origin->y + (l + 0.5) * Rast->getPixelHeight()));
+    }
+  }
+
+  std::vector<float> Values(Coords.size());
+  Rast->getValuesOfCoordinates(Coords.data(),Coords.size(),Values.data());
+
+  for (unsigned int i = 0; i < Coords.size(); i++)
+  {
+    BOOST_CHECK_EQUAL(Values[i],Rast->getValueOfCoordinate(Coords[i]));
+  }
+
+  geos::geom::Coordinate Outside(Origin->x - Rast->getPixelWidth(), Origin->y);
+  float OutsideValue;
+  BOOST_CHECK_THROW(Rast->getValuesOfCoordinates(&Outside,1,&OutsideValue),openfluid::base::FrameworkException);
+
+  delete Origin;
+  delete Rast;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_getInterpolatedValuesOfCoordinates)
+{
+  openfluid::core::GeoRasterValue Val(CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue", "dem.asc");
+
+  openfluid::landr::RasterDataset* Rast = new openfluid::landr::RasterDataset(Val);
+
+  geos::geom::Coordinate* Origin = Rast->computeOrigin();
+  double PixelWidth = Rast->getPixelWidth();
+  double PixelHeight = Rast->getPixelHeight();
+
+  // the centers of pixels (3,2) and (4,2), and the middle of both
+  std::vector<geos::geom::Coordinate> Coords;
+  Coords.push_back(geos::geom::Coordinate(Origin->x + 3.5 * PixelWidth, Origin->y + 2.5 * PixelHeight));
+  Coords.push_back(geos::geom::Coordinate(Origin->x + 4.5 * PixelWidth, Origin->y + 2.5 * PixelHeight));
+  Coords.push_back(geos::geom::Coordinate(Origin->x + 4 * PixelWidth, Origin->y + 2.5 * PixelHeight));
+
+  std::vector<float> Nearest(Coords.size());
+  std::vector<float> Bilinear(Coords.size());
+  std::vector<float> Bicubic(Coords.size());
+
+  Rast->getInterpolatedValuesOfCoordinates(Coords.data(),Coords.size(),Nearest.data(),
+                                           openfluid::landr::RasterDataset::NEAREST);
+  Rast->getInterpolatedValuesOfCoordinates(Coords.data(),Coords.size(),Bilinear.data());
+  Rast->getInterpolatedValuesOfCoordinates(Coords.data(),Coords.size(),Bicubic.data(),
+                                           openfluid::landr::RasterDataset::BICUBIC);
+
+  float Pixel32 = Rast->getValueOfPixel(3,2);
+  float Pixel42 = Rast->getValueOfPixel(4,2);
+
+  BOOST_CHECK_EQUAL(Nearest[0],Pixel32);
+
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Bilinear[0],Pixel32));
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Bilinear[1],Pixel42));
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Bilinear[2],(Pixel32 + Pixel42) / 2));
+
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Bicubic[0],Pixel32));
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Bicubic[1],Pixel42));
+
+  geos::geom::Coordinate Outside(Origin->x - PixelWidth, Origin->y);
+  float OutsideValue;
+  BOOST_CHECK_THROW(Rast->getInterpolatedValuesOfCoordinates(&Outside,1,&OutsideValue),
+                    openfluid::base::FrameworkException);
+
+  delete Origin;
+  delete Rast;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_outOfExtentAndNoDataPolicies)
+{
+  openfluid::core::GeoRasterValue Val(CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue", "dem.asc");
+
+  openfluid::landr::RasterDataset* Rast = new openfluid::landr::RasterDataset(Val);
+
+  geos::geom::Coordinate* Origin = Rast->computeOrigin();
+  const double PixelWidth = Rast->getPixelWidth();
+  const double PixelHeight = Rast->getPixelHeight();
+
+  geos::geom::Coordinate Inside(Origin->x + 0.5 * PixelWidth, Origin->y + 0.5 * PixelHeight);
+  geos::geom::Coordinate Outside(Origin->x - 10 * PixelWidth, Origin->y + 0.5 * PixelHeight);
+  // less than one pixel before the origin
+  geos::geom::Coordinate JustOutside(Origin->x - 0.5 * PixelWidth, Origin->y + 0.5 * PixelHeight);
+
+  BOOST_CHECK(Rast->isInExtent(Inside));
+  BOOST_CHECK(!Rast->isInExtent(Outside));
+  BOOST_CHECK(!Rast->isInExtent(JustOutside));
+  BOOST_CHECK_EQUAL(Rast->getPixelFromCoordinate(JustOutside).first,-1);
+  BOOST_CHECK(!Rast->intersectsExtent(geos::geom::Envelope(Outside,Outside)));
+  BOOST_CHECK(Rast->intersectsExtent(geos::geom::Envelope(Outside,Inside)));
+
+  BOOST_CHECK_EQUAL(Rast->getOutOfExtentPolicy(),openfluid::landr::RasterDataset::OUT_OF_EXTENT_THROW);
+  BOOST_CHECK_THROW(Rast->getValueOfPixel(-1,0),openfluid::base::FrameworkException);
+  BOOST_CHECK_THROW(Rast->getValueOfCoordinate(Outside),openfluid::base::FrameworkException);
+  BOOST_CHECK_THROW(Rast->getValueOfCoordinate(JustOutside),openfluid::base::FrameworkException);
+
+  Rast->setOutOfExtentPolicy(openfluid::landr::RasterDataset::OUT_OF_EXTENT_NAN);
+
+  BOOST_CHECK(std::isnan(Rast->getValueOfPixel(-1,0)));
+  BOOST_CHECK(std::isnan(Rast->getValueOfPixel(0,20)));
+
+  const geos::geom::Coordinate Coords[4] = {Inside, Outside, Inside, JustOutside};
+  float Values[4];
+
+  Rast->getValuesOfCoordinates(Coords,4,Values);
+  BOOST_CHECK_EQUAL(Values[0],Rast->getValueOfPixel(0,0));
+  BOOST_CHECK(std::isnan(Values[1]));
+  BOOST_CHECK_EQUAL(Values[2],Values[0]);
+  BOOST_CHECK(std::isnan(Values[3]));
+  BOOST_CHECK(std::isnan(Rast->getValueOfCoordinate(JustOutside)));
+
+  Rast->getInterpolatedValuesOfCoordinates(Coords,4,Values);
+  BOOST_CHECK(!std::isnan(Values[0]));
+  BOOST_CHECK(std::isnan(Values[1]));
+  BOOST_CHECK(std::isnan(Values[3]));
+
+  delete Origin;
+  delete Rast;
+
+  // nodata pixels
+  const std::string OutputPath = CONFIGTESTS_DATA_OUTPUT_DIR + "/NoData";
+  VSIMkdir(OutputPath.c_str(),0755);
+
+  std::ofstream NoDataFile(OutputPath + "/nodata.asc");
+  NoDataFile << "ncols 3\nnrows 2\nxllcorner 0\nyllcorner 0\ncellsize 1\nNODATA_value -9999\n"
+             << "1 -9999 3\n4 5 6\n";
+  NoDataFile.close();
+
+  openfluid::core::GeoRasterValue NoDataVal(OutputPath, "nodata.asc");
+
+  Rast = new openfluid::landr::RasterDataset(NoDataVal);
+
+  BOOST_CHECK_EQUAL(Rast->getNoDataPolicy(),openfluid::landr::RasterDataset::NODATA_KEEP);
+  BOOST_CHECK_EQUAL(Rast->getValueOfPixel(1,0),-9999);
+
+  Rast->setNoDataPolicy(openfluid::landr::RasterDataset::NODATA_NAN);
+
+  BOOST_CHECK(std::isnan(Rast->getValueOfPixel(1,0)));
+  BOOST_CHECK_EQUAL(Rast->getValueOfPixel(0,0),1);
+  BOOST_CHECK_EQUAL(Rast->getValueOfPixel(2,1),6);
+
+  delete Rast;
+
+  // without georeferencing, the envelope is empty and coordinates can not be located
+  GDALDataset* NotGeoreferenced =
+    GetGDALDriverManager()->GetDriverByName("GTiff")->Create((OutputPath + "/nogeo.tif").c_str(),3,2,1,
+                                                              GDT_Float32,nullptr);
+  GDALClose(NotGeoreferenced);
+
+  openfluid::core::GeoRasterValue NoGeoVal(OutputPath, "nogeo.tif");
+
+  Rast = new openfluid::landr::RasterDataset(NoGeoVal);
+
+  BOOST_CHECK(!Rast->envelope().IsInit());
+  BOOST_CHECK_THROW(Rast->getPixelFromCoordinate(geos::geom::Coordinate(0.5,0.5)),
+                    openfluid::base::FrameworkException);
+  BOOST_CHECK_THROW(Rast->isInExtent(geos::geom::Coordinate(0.5,0.5)),openfluid::base::FrameworkException);
+
+  delete Rast;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_computeZonalStatistics)
+{
+  openfluid::core::GeoRasterValue Val(CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue", "dem.asc");
+
+  openfluid::landr::RasterDataset* Rast = new openfluid::landr::RasterDataset(Val);
+
+  geos::geom::Coordinate* Origin = Rast->computeOrigin();
+  double PixelWidth = Rast->getPixelWidth();
+  double PixelHeight = Rast->getPixelHeight();
+
+  // zone over lines 1 and 2, from a quarter of column 1 to a quarter of column 3
+  geos::geom::Envelope ZoneEnvelope(Origin->x + 1.25 * PixelWidth, Origin->x + 3.25 * PixelWidth,
+                                    Origin->y + 1 * PixelHeight, Origin->y + 3 * PixelHeight);
+  std::unique_ptr<geos::geom::Geometry> Zone =
+      geos::geom::GeometryFactory::getDefaultInstance()->toGeometry(&ZoneEnvelope);
+
+  double ExpectedSum = 0;
+  double ExpectedMin = Rast->getValueOfPixel(1,1);
+  double ExpectedMax = ExpectedMin;
+  const double Coverages[3] = {0.75, 1, 0.25};
+
+  for (int l = 1; l <= 2; l++)
+  {
+    for (int c = 1; c <= 3; c++)
+    {
+      double PixelVal = Rast->getValueOfPixel(c,l);
+      ExpectedSum += Coverages[c-1] * PixelVal;
+      ExpectedMin = std::min(ExpectedMin,PixelVal);
+      ExpectedMax = std::max(ExpectedMax,PixelVal);
+    }
+  }
+
+  openfluid::landr::RasterDataset::ZonalStatistics Stats = Rast->computeZonalStatistics(Zone.get());
+
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Stats.Count,4.0));
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Stats.Sum,ExpectedSum));
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Stats.Mean,ExpectedSum / 4));
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Stats.Min,ExpectedMin));
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Stats.Max,ExpectedMax));
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Stats.CoveredArea,Zone->getArea()));
+  BOOST_CHECK(Stats.StdDev >= 0 && Stats.StdDev <= ExpectedMax - ExpectedMin);
+
+  // without exact coverage, only the pixels of columns 1 and 2 have their center inside the zone
+  Stats = Rast->computeZonalStatistics(Zone.get(),false);
+
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Stats.Count,4.0));
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Stats.Sum,Rast->getValueOfPixel(1,1) + Rast->getValueOfPixel(2,1) +
+                                                           Rast->getValueOfPixel(1,2) + Rast->getValueOfPixel(2,2)));
+
+  // zone outside of the raster
+  geos::geom::Envelope OutsideEnvelope(Origin->x - 3 * PixelWidth, Origin->x - PixelWidth,
+                                       Origin->y, Origin->y + 2 * PixelHeight);
+  std::unique_ptr<geos::geom::Geometry> Outside =
+      geos::geom::GeometryFactory::getDefaultInstance()->toGeometry(&OutsideEnvelope);
+
+  Stats = Rast->computeZonalStatistics(Outside.get());
+  BOOST_CHECK_EQUAL(Stats.Count,0);
+  BOOST_CHECK(std::isnan(Stats.Mean));
+
+  delete Origin;
+  delete Rast;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_overviews)
+{
+  // overviews are written aside the raster, which is copied out of the input data
+  const std::string OutputPath = CONFIGTESTS_DATA_OUTPUT_DIR + "/Overviews";
+  VSIMkdir(OutputPath.c_str(),0755);
+  VSIUnlink((OutputPath + "/dem.asc.ovr").c_str());
+  CPLCopyFile((OutputPath + "/dem.asc").c_str(),(CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue/dem.asc").c_str());
+
+  openfluid::core::GeoRasterValue Val(OutputPath, "dem.asc");
+
+  openfluid::landr::RasterDataset* Rast = new openfluid::landr::RasterDataset(Val);
+
+  BOOST_CHECK_EQUAL(Rast->getOverviewsCount(),0);
+  BOOST_CHECK_EQUAL(&Rast->overview(0),Rast);
+  BOOST_CHECK_THROW(Rast->overview(1),openfluid::base::FrameworkException);
+
+  geos::geom::Coordinate* Origin = Rast->computeOrigin();
+  geos::geom::Envelope ZoneEnvelope(Origin->x, Origin->x + 20 * Rast->getPixelWidth(),
+                                    Origin->y, Origin->y + 20 * Rast->getPixelHeight());
+  std::unique_ptr<geos::geom::Geometry> Zone =
+      geos::geom::GeometryFactory::getDefaultInstance()->toGeometry(&ZoneEnvelope);
+  delete Origin;
+
+  // full resolution needed
+  BOOST_CHECK_EQUAL(Rast->selectOverviewLevel(Zone->getArea(),0),0);
+  BOOST_CHECK_EQUAL(Rast->selectOverviewLevel(Zone->getArea(),0.01),0);
+  BOOST_CHECK_EQUAL(Rast->getOverviewsCount(),0);
+
+  // 20x20 pixels, a 10x10 overview is accurate enough and is built on demand
+  BOOST_CHECK_EQUAL(Rast->selectOverviewLevel(Zone->getArea(),0.5),1);
+  BOOST_CHECK_EQUAL(Rast->getOverviewsCount(),1);
+
+  openfluid::landr::RasterDataset& Overview = Rast->overview(1);
+
+  BOOST_CHECK_EQUAL(Overview.source()->GetRasterXSize(),10);
+  BOOST_CHECK(openfluid::scientific::isVeryClose(Overview.getPixelWidth(),2 * Rast->getPixelWidth()));
+
+  openfluid::landr::RasterDataset::ZonalStatistics Stats = Rast->computeZonalStatistics(Zone.get());
+  openfluid::landr::RasterDataset::ZonalStatistics CoarseStats = Overview.computeZonalStatistics(Zone.get());
+
+  BOOST_CHECK(openfluid::scientific::isVeryClose(CoarseStats.CoveredArea,Stats.CoveredArea));
+  BOOST_CHECK(std::fabs(CoarseStats.Mean - Stats.Mean) < 0.01);
+  BOOST_CHECK(CoarseStats.Min >= Stats.Min && CoarseStats.Max <= Stats.Max);
+
+  // the policies of the raster are applied to its opened overviews
+  BOOST_CHECK_THROW(Overview.getValueOfPixel(-1,0),openfluid::base::FrameworkException);
+
+  Rast->setOutOfExtentPolicy(openfluid::landr::RasterDataset::OUT_OF_EXTENT_NAN);
+  Rast->setNoDataPolicy(openfluid::landr::RasterDataset::NODATA_NAN);
+
+  BOOST_CHECK_EQUAL(Overview.getOutOfExtentPolicy(),openfluid::landr::RasterDataset::OUT_OF_EXTENT_NAN);
+  BOOST_CHECK_EQUAL(Overview.getNoDataPolicy(),openfluid::landr::RasterDataset::NODATA_NAN);
+  BOOST_CHECK(std::isnan(Overview.getValueOfPixel(-1,0)));
+
+  delete Rast;
+
+  // and to the overviews opened later
+  Rast = new openfluid::landr::RasterDataset(Val);
+  Rast->setOutOfExtentPolicy(openfluid::landr::RasterDataset::OUT_OF_EXTENT_NAN);
+
+  BOOST_CHECK_EQUAL(Rast->overview(1).getOutOfExtentPolicy(),openfluid::landr::RasterDataset::OUT_OF_EXTENT_NAN);
+  BOOST_CHECK_EQUAL(Rast->overview(1).getNoDataPolicy(),openfluid::landr::RasterDataset::NODATA_KEEP);
+
+  delete Rast;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_Polygonize)
 {
   // integer values
@@ -292,6 +834,136 @@ BOOST_AUTO_TEST_CASE(check_Polygonize)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_Polygonize_tiles)
+{
+  openfluid::core::GeoRasterValue RasterVal(CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue", "dem.jpeg");
+
+  openfluid::landr::RasterDataset* Rast = new openfluid::landr::RasterDataset(RasterVal);
+  openfluid::landr::RasterDataset* TiledRast = new openfluid::landr::RasterDataset(RasterVal);
+
+  openfluid::landr::VectorDataset* VectorVal = Rast->polygonize("TestOutSequential.shp","RasterVal");
+  openfluid::landr::VectorDataset* TiledVectorVal = TiledRast->polygonize("TestOutTiled.shp","RasterVal",1,7,4);
+
+  OGRLayer* VectorLayer = VectorVal->layer(0);
+  OGRLayer* TiledLayer = TiledVectorVal->layer(0);
+
+  BOOST_CHECK_EQUAL(TiledLayer->GetFeatureCount(), VectorLayer->GetFeatureCount());
+
+  // same area by pixel value, whatever the order of the polygons
+  std::map<int, double> Areas, TiledAreas;
+  OGRFeature* Feat;
+
+  VectorLayer->ResetReading();
+  while ((Feat = VectorLayer->GetNextFeature()) != nullptr)
+  {
+    Areas[Feat->GetFieldAsInteger("RasterVal")] += static_cast<OGRPolygon*>(Feat->GetGeometryRef())->get_Area();
+    OGRFeature::DestroyFeature(Feat);
+  }
+
+  TiledLayer->ResetReading();
+  while ((Feat = TiledLayer->GetNextFeature()) != nullptr)
+  {
+    BOOST_CHECK_EQUAL(wkbFlatten(Feat->GetGeometryRef()->getGeometryType()), wkbPolygon);
+    TiledAreas[Feat->GetFieldAsInteger("RasterVal")] += static_cast<OGRPolygon*>(Feat->GetGeometryRef())->get_Area();
+    OGRFeature::DestroyFeature(Feat);
+  }
+
+  BOOST_REQUIRE_EQUAL(TiledAreas.size(), Areas.size());
+
+  for (const std::pair<const int, double>& Area : Areas)
+  {
+    BOOST_CHECK(openfluid::scientific::isVeryClose(TiledAreas[Area.first], Area.second));
+  }
+
+  delete Rast;
+  delete TiledRast;
+  delete VectorVal;
+  delete TiledVectorVal;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_Polygonize_cache)
+{
+  openfluid::core::GeoRasterValue RasterVal(CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue", "dem.asc");
+  openfluid::core::GeoRasterValue OtherRasterVal(CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue", "dem.jpeg");
+
+  openfluid::landr::RasterDataset* Rast = new openfluid::landr::RasterDataset(RasterVal);
+  openfluid::landr::RasterDataset* OtherRast = new openfluid::landr::RasterDataset(OtherRasterVal);
+
+  BOOST_CHECK_EQUAL(Rast->computeContentHash().size(),16);
+  BOOST_CHECK_EQUAL(Rast->computeContentHash(),openfluid::landr::RasterDataset(*Rast).computeContentHash());
+  BOOST_CHECK(Rast->computeContentHash() != OtherRast->computeContentHash());
+
+  delete OtherRast;
+
+  const std::string CachePath = CONFIGTESTS_DATA_OUTPUT_DIR + "/PolygonizedCache";
+  CPLUnlinkTree(CachePath.c_str());
+
+  openfluid::landr::RasterDataset::setPolygonizedCachePath(CachePath);
+  BOOST_CHECK_EQUAL(openfluid::landr::RasterDataset::getPolygonizedCachePath(),CachePath);
+
+  // first polygonization populates the cache
+  openfluid::landr::VectorDataset* VectorVal = Rast->polygonize("TestOutCached.shp");
+  BOOST_CHECK_EQUAL(VectorVal->layer(0)->GetFeatureCount(), 400);
+
+  VSIStatBufL Stat;
+  const std::string EntryPath = CachePath + "/" + Rast->computeContentHash() + "_" +
+                                openfluid::landr::RasterDataset::getDefaultPolygonizedFieldName();
+  BOOST_CHECK_EQUAL(VSIStatL((EntryPath + "/polygonized.shp").c_str(),&Stat),0);
+  BOOST_CHECK(VSIStatL((EntryPath + ".lock").c_str(),&Stat) != 0);
+
+  delete Rast;
+  delete VectorVal;
+
+  // second polygonization is read from the cache
+  Rast = new openfluid::landr::RasterDataset(RasterVal);
+
+  VectorVal = Rast->polygonize("TestOutFromCache.shp");
+
+  OGRLayer* VectorLayer = VectorVal->layer(0);
+
+  BOOST_CHECK_EQUAL(VectorLayer->GetFeatureCount(), 400);
+
+  openfluid::core::DoubleValue Val =
+    VectorLayer->GetFeature(331)->
+      GetFieldAsDouble(openfluid::landr::RasterDataset::getDefaultPolygonizedFieldName().c_str());
+  BOOST_CHECK( openfluid::scientific::isVeryClose(Val.get(), 42.327));
+
+  delete Rast;
+  delete VectorVal;
+
+  // a lock left by a dead process is broken once it is older than the lock timeout
+  BOOST_CHECK_EQUAL(openfluid::landr::RasterDataset::getPolygonizedCacheLockTimeout(),60);
+
+  CPLUnlinkTree(EntryPath.c_str());
+  VSIMkdir((EntryPath + ".lock").c_str(),0755);
+  openfluid::landr::RasterDataset::setPolygonizedCacheLockTimeout(0);
+
+  Rast = new openfluid::landr::RasterDataset(RasterVal);
+  VectorVal = Rast->polygonize("TestOutStaleLock.shp");
+
+  BOOST_CHECK_EQUAL(VectorVal->layer(0)->GetFeatureCount(), 400);
+  BOOST_CHECK_EQUAL(VSIStatL((EntryPath + "/polygonized.shp").c_str(),&Stat),0);
+  BOOST_CHECK(VSIStatL((EntryPath + ".lock").c_str(),&Stat) != 0);
+
+  openfluid::landr::RasterDataset::setPolygonizedCacheLockTimeout(60);
+  openfluid::landr::RasterDataset::setPolygonizedCachePath("");
+
+  delete Rast;
+  delete VectorVal;
+
+  CPLUnlinkTree(CachePath.c_str());
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_envelope)
 {
   openfluid::core::GeoRasterValue RasterVal(CONFIGTESTS_DATA_INPUT_DIR + "/GeoRasterValue", "dem.jpeg");
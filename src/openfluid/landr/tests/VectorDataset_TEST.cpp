@@ -43,9 +43,17 @@
 #define BOOST_TEST_MODULE unittest_vectordataset
 
 
+#include <algorithm>
+#include <set>
+#include <memory>
+#include <vector>
+
 #include <boost/test/unit_test.hpp>
 
 #include <geos/geom/Geometry.h>
+#include <geos/geom/CoordinateSequence.h>
+#include <geos/geom/GeometryFactory.h>
+#include <geos/geom/Point.h>
 
 #include <openfluid/landr/GEOSHelpers.hpp>
 #include <openfluid/base/FrameworkException.hpp>
@@ -295,6 +303,45 @@ BOOST_AUTO_TEST_CASE(check_parse)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_geometriesView)
+{
+  openfluid::core::GeoVectorValue Value(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "SU.shp");
+
+  openfluid::landr::VectorDataset* Vect = new openfluid::landr::VectorDataset(Value);
+
+  const openfluid::landr::GeometriesView& View = Vect->geometriesView();
+  openfluid::landr::VectorDataset::FeaturesList_t Features = Vect->features();
+
+  BOOST_REQUIRE_EQUAL(View.size(), 24);
+
+  unsigned int i = 0;
+  for (openfluid::landr::VectorDataset::FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
+  {
+    BOOST_CHECK(View.at(i) == it->second);
+    BOOST_CHECK(View.intersects(it->second));
+
+    std::vector<unsigned int> Found = View.queryEnvelope(it->second);
+    BOOST_CHECK(std::find(Found.begin(),Found.end(),i) != Found.end());
+    BOOST_CHECK(std::is_sorted(Found.begin(),Found.end()));
+    i++;
+  }
+
+  // a point far away from the layer
+  OGREnvelope Envelope = Vect->envelope();
+  std::unique_ptr<geos::geom::Point> FarPoint(geos::geom::GeometryFactory::getDefaultInstance()->createPoint(
+      geos::geom::Coordinate(Envelope.MaxX + 1000, Envelope.MaxY + 1000)));
+
+  BOOST_CHECK(!View.intersects(FarPoint.get()));
+  BOOST_CHECK(View.queryEnvelope(FarPoint.get()).empty());
+
+  delete Vect;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_Geometry_Properties)
 {
   openfluid::core::GeoVectorValue ValuePolyg(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "SU.shp");
@@ -358,6 +405,80 @@ BOOST_AUTO_TEST_CASE(check_setIndexIntField)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_writeSession)
+{
+  openfluid::core::GeoVectorValue Value(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "SU.shp");
+
+  openfluid::landr::VectorDataset* Vect = new openfluid::landr::VectorDataset(Value);
+
+  Vect->addAField("Batch",OFTInteger);
+
+  OGRFeature* Feat;
+  OGRLayer* Layer = Vect->layer();
+
+  Layer->ResetReading();
+  Feat = Layer->GetNextFeature();
+  BOOST_CHECK_THROW(Vect->writeFeature(Feat),openfluid::base::FrameworkException);
+  BOOST_CHECK_THROW(Vect->commitWriteSession(),openfluid::base::FrameworkException);
+  OGRFeature::DestroyFeature(Feat);
+
+  // a small batch size forces several commits during the session
+  Vect->beginWriteSession(5);
+  BOOST_CHECK_THROW(Vect->beginWriteSession(5),openfluid::base::FrameworkException);
+
+  Layer->ResetReading();
+  int FieldValue = 100;
+  while ((Feat = Layer->GetNextFeature()) != nullptr)
+  {
+    Feat->SetField("Batch",FieldValue++);
+    Vect->writeFeature(Feat);
+    OGRFeature::DestroyFeature(Feat);
+  }
+
+  Vect->commitWriteSession();
+
+  BOOST_CHECK_EQUAL(Vect->isIntValueSet("Batch",100),true);
+  BOOST_CHECK_EQUAL(Vect->isIntValueSet("Batch",123),true);
+  BOOST_CHECK_EQUAL(Vect->isIntValueSet("Batch",FieldValue),false);
+
+  // a rolled back session is ended, even on formats without rollback such as shapefiles
+  BOOST_CHECK_THROW(Vect->rollbackWriteSession(),openfluid::base::FrameworkException);
+
+  Vect->beginWriteSession(5);
+  try
+  {
+    Vect->rollbackWriteSession();
+  }
+  catch (openfluid::base::FrameworkException&)
+  {
+  }
+
+  Layer->ResetReading();
+  Feat = Layer->GetNextFeature();
+  BOOST_CHECK_THROW(Vect->writeFeature(Feat),openfluid::base::FrameworkException);
+  OGRFeature::DestroyFeature(Feat);
+
+  // a session left by an exception is ended by its guard
+  try
+  {
+    openfluid::landr::VectorDataset::WriteSessionGuard Session(Vect,5);
+    throw openfluid::base::FrameworkException(OPENFLUID_CODE_LOCATION,"interrupted");
+  }
+  catch (openfluid::base::FrameworkException&)
+  {
+  }
+
+  BOOST_CHECK_NO_THROW(Vect->beginWriteSession(5));
+  Vect->commitWriteSession();
+
+  delete Vect;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_envelope)
 {
   openfluid::core::GeoVectorValue Value(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "SU.shp");
@@ -411,6 +532,39 @@ BOOST_AUTO_TEST_CASE(check_findOverlap)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_findOverlap_uniquePairs)
+{
+  openfluid::core::GeoVectorValue ValueSU(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "badSU_overlap.shp");
+
+  openfluid::landr::VectorDataset* VectSU = new openfluid::landr::VectorDataset(ValueSU);
+
+  std::list<std::pair<OGRFeature*, OGRFeature*> > lOverlap=VectSU->findOverlap();
+  std::set<std::pair<GIntBig, GIntBig> > Pairs;
+
+  for (std::list<std::pair<OGRFeature*, OGRFeature*> >::iterator it = lOverlap.begin(); it != lOverlap.end(); ++it)
+  {
+    BOOST_CHECK((*it).first->GetFID() < (*it).second->GetFID());
+    Pairs.insert(std::make_pair((*it).first->GetFID(), (*it).second->GetFID()));
+  }
+
+  BOOST_CHECK_EQUAL(Pairs.size(), lOverlap.size());
+
+  // no overlap in a clean layer
+  openfluid::core::GeoVectorValue ValueClean(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "SU.shp");
+
+  openfluid::landr::VectorDataset* VectClean = new openfluid::landr::VectorDataset(ValueClean);
+
+  BOOST_CHECK_EQUAL(VectClean->findOverlap().size(), 0);
+
+  delete VectSU;
+  delete VectClean;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_findGap)
 {
   openfluid::core::GeoVectorValue ValueSU(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "badSU_non_snapped.shp");
@@ -442,6 +596,42 @@ BOOST_AUTO_TEST_CASE(check_findGap)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_findGap_deterministic)
+{
+  openfluid::core::GeoVectorValue ValueSU(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "badSU_non_snapped.shp");
+
+  openfluid::landr::VectorDataset* VectSU = new openfluid::landr::VectorDataset(ValueSU);
+
+  std::vector<std::pair<GIntBig, GIntBig> > FirstRun;
+
+  std::list<std::pair<OGRFeature*, OGRFeature*> > lGap=VectSU->findGap(4);
+  for (std::list<std::pair<OGRFeature*, OGRFeature*> >::iterator it = lGap.begin(); it != lGap.end(); ++it)
+  {
+    BOOST_CHECK((*it).first->GetFID() < (*it).second->GetFID());
+    FirstRun.push_back(std::make_pair((*it).first->GetFID(), (*it).second->GetFID()));
+  }
+
+  for (unsigned int r = 0; r < 3; r++)
+  {
+    lGap=VectSU->findGap(4);
+    BOOST_REQUIRE_EQUAL(lGap.size(), FirstRun.size());
+
+    std::list<std::pair<OGRFeature*, OGRFeature*> >::iterator it = lGap.begin();
+    for (unsigned int i = 0; i < FirstRun.size(); i++, ++it)
+    {
+      BOOST_CHECK_EQUAL((*it).first->GetFID(), FirstRun[i].first);
+      BOOST_CHECK_EQUAL((*it).second->GetFID(), FirstRun[i].second);
+    }
+  }
+
+  delete VectSU;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_checkTopology)
 {
   openfluid::core::GeoVectorValue ValueSU(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "badSU_non_snapped.shp");
@@ -475,6 +665,54 @@ BOOST_AUTO_TEST_CASE(check_checkTopology)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_computeTopologyReport)
+{
+  openfluid::core::GeoVectorValue ValueSU(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "badSU_non_snapped.shp");
+
+  openfluid::landr::VectorDataset* VectSU = new openfluid::landr::VectorDataset(ValueSU);
+
+  std::vector<openfluid::landr::VectorDataset::TopologyError> Report = VectSU->computeTopologyReport(0.1);
+  std::vector<openfluid::landr::VectorDataset::TopologyError> SerialReport = VectSU->computeTopologyReport(0.1,0,1);
+
+  unsigned int OverlapsCount = 0;
+  unsigned int GapsCount = 0;
+
+  for (unsigned int i = 0; i < Report.size(); i++)
+  {
+    if (Report[i].Class == openfluid::landr::VectorDataset::TopologyError::OVERLAP)
+    {
+      OverlapsCount++;
+    }
+    else if (Report[i].Class == openfluid::landr::VectorDataset::TopologyError::GAP)
+    {
+      GapsCount++;
+    }
+
+    if (Report[i].Class != openfluid::landr::VectorDataset::TopologyError::INVALID_GEOMETRY)
+    {
+      BOOST_CHECK(Report[i].NeighbourFID != Report[i].FID);
+    }
+  }
+
+  BOOST_CHECK_EQUAL(OverlapsCount,1);
+  BOOST_CHECK_EQUAL(GapsCount,3);
+
+  BOOST_REQUIRE_EQUAL(Report.size(),SerialReport.size());
+  for (unsigned int i = 0; i < Report.size(); i++)
+  {
+    BOOST_CHECK_EQUAL(Report[i].FID,SerialReport[i].FID);
+    BOOST_CHECK_EQUAL(Report[i].Class,SerialReport[i].Class);
+    BOOST_CHECK_EQUAL(Report[i].NeighbourFID,SerialReport[i].NeighbourFID);
+  }
+
+  delete VectSU;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_snapVertices)
 {
   openfluid::core::GeoVectorValue ValueRS(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "RS_To_Snap.shp");
@@ -517,6 +755,167 @@ BOOST_AUTO_TEST_CASE(check_snapVertices)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_snapLineNodes_stable)
+{
+  openfluid::core::GeoVectorValue ValueRS(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "RS_To_Snap.shp");
+  openfluid::landr::VectorDataset* VectRS = new openfluid::landr::VectorDataset(ValueRS);
+
+  unsigned int FeaturesCount = VectRS->features().size();
+
+  VectRS->snapVertices(2);
+  BOOST_CHECK_EQUAL(VectRS->features().size(),FeaturesCount);
+
+  std::string FirstPass = VectRS->geometries()->toString();
+
+  // snapping already snapped lines must not move any node
+  VectRS->snapVertices(2);
+  BOOST_CHECK_EQUAL(VectRS->geometries()->toString(),FirstPass);
+
+  delete VectRS;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_snapVertices_stable)
+{
+  openfluid::core::GeoVectorValue ValueSU(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "SU_To_Snap.shp");
+  openfluid::landr::VectorDataset* VectSU = new openfluid::landr::VectorDataset(ValueSU);
+
+  VectSU->snapVertices(2);
+
+  std::vector<std::string> FirstPass;
+  openfluid::landr::VectorDataset::FeaturesList_t Features = VectSU->features();
+  for (openfluid::landr::VectorDataset::FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
+  {
+    FirstPass.push_back((*it).second->toString());
+  }
+
+  // snapping an already snapped layer must not move any vertex
+  VectSU->snapVertices(2);
+
+  Features = VectSU->features();
+  BOOST_REQUIRE_EQUAL(Features.size(),FirstPass.size());
+
+  unsigned int i = 0;
+  for (openfluid::landr::VectorDataset::FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
+  {
+    BOOST_CHECK_EQUAL((*it).second->toString(),FirstPass[i++]);
+  }
+
+  BOOST_CHECK_EQUAL(VectSU->findGap(2).size(),0);
+
+  delete VectSU;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_snapVertices_densifiedSharedEdge)
+{
+  openfluid::landr::VectorDataset* Vect = new openfluid::landr::VectorDataset("densified.shp");
+  Vect->addALayer("densified",wkbPolygon);
+
+  // two squares sharing the edge x=10, densified every 0.1 (10 times below the threshold),
+  // the first one exactly on the edge, the second one 0.05 away from it
+  for (unsigned int p = 0; p < 2; p++)
+  {
+    double EdgeX = (p == 0 ? 10 : 10.05);
+    double OtherX = (p == 0 ? 0 : 20);
+
+    OGRLinearRing Ring;
+    Ring.addPoint(OtherX,0);
+    for (unsigned int i = 0; i <= 100; i++)
+    {
+      Ring.addPoint(EdgeX,i * 0.1);
+    }
+    Ring.addPoint(OtherX,10);
+    Ring.closeRings();
+
+    OGRPolygon* Geom = new OGRPolygon();
+    Geom->addRing(&Ring);
+
+    OGRFeature* Feat = OGRFeature::CreateFeature(Vect->layerDef());
+    Feat->SetGeometryDirectly(Geom);
+    BOOST_REQUIRE_EQUAL(Vect->layer()->CreateFeature(Feat),OGRERR_NONE);
+    OGRFeature::DestroyFeature(Feat);
+  }
+
+  Vect->snapVertices(1);
+
+  openfluid::landr::VectorDataset::FeaturesList_t Features = Vect->features();
+  BOOST_REQUIRE_EQUAL(Features.size(),2);
+
+  // every vertex of the second edge is snapped onto its counterpart only, the edges are not collapsed
+  for (openfluid::landr::VectorDataset::FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
+  {
+    BOOST_CHECK_EQUAL((*it).second->getNumPoints(),104);
+    BOOST_CHECK(openfluid::scientific::isVeryClose((*it).second->getArea(),100.0));
+  }
+  BOOST_CHECK_EQUAL(Vect->findGap(1).size(),0);
+
+  std::string FirstPass = Vect->geometries()->toString();
+
+  // the shared vertices coincide, a new snapping must not move any of them
+  Vect->snapVertices(1);
+  BOOST_CHECK_EQUAL(Vect->geometries()->toString(),FirstPass);
+
+  delete Vect;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
+BOOST_AUTO_TEST_CASE(check_snapLineNodes_threshold)
+{
+  openfluid::landr::VectorDataset* Vect = new openfluid::landr::VectorDataset("thresholdRS.shp");
+  Vect->addALayer("thresholdRS",wkbLineString);
+
+  // the second line starts exactly at the threshold from the end of the first one,
+  // the third one starts just beyond the threshold from the end of the second one
+  const double Lines[3][4] = { {0,0,10,0}, {12,0,20,0}, {20,2.5,30,2.5} };
+
+  for (unsigned int l = 0; l < 3; l++)
+  {
+    OGRLineString* Geom = new OGRLineString();
+    Geom->addPoint(Lines[l][0],Lines[l][1]);
+    Geom->addPoint(Lines[l][2],Lines[l][3]);
+
+    OGRFeature* Feat = OGRFeature::CreateFeature(Vect->layerDef());
+    Feat->SetGeometryDirectly(Geom);
+    BOOST_REQUIRE_EQUAL(Vect->layer()->CreateFeature(Feat),OGRERR_NONE);
+    OGRFeature::DestroyFeature(Feat);
+  }
+
+  Vect->snapVertices(2);
+
+  openfluid::landr::VectorDataset::FeaturesList_t Features = Vect->features();
+  BOOST_REQUIRE_EQUAL(Features.size(),3);
+
+  std::vector<std::unique_ptr<geos::geom::CoordinateSequence>> Coords;
+  for (openfluid::landr::VectorDataset::FeaturesList_t::iterator it = Features.begin(); it != Features.end(); ++it)
+  {
+    Coords.push_back((*it).second->getCoordinates());
+  }
+
+  BOOST_CHECK(Coords[1]->getAt(0).equals2D(geos::geom::Coordinate(10,0)));
+  BOOST_CHECK(Coords[1]->getAt(1).equals2D(geos::geom::Coordinate(20,0)));
+  BOOST_CHECK(Coords[2]->getAt(0).equals2D(geos::geom::Coordinate(20,2.5)));
+
+  delete Vect;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_Overlap_and_Snap_Polygon)
 {
   openfluid::core::GeoVectorValue ValueSU(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "badSU_non_snapped.shp");
@@ -546,6 +945,31 @@ BOOST_AUTO_TEST_CASE(check_Overlap_and_Snap_Polygon)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_cleanOverlap_deterministic)
+{
+  openfluid::core::GeoVectorValue ValueSU(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "badSU_non_snapped.shp");
+
+  openfluid::landr::VectorDataset* VectSU1 = new openfluid::landr::VectorDataset(ValueSU);
+  openfluid::landr::VectorDataset* VectSU2 = new openfluid::landr::VectorDataset(*VectSU1);
+
+  unsigned int FeaturesCount = VectSU1->features().size();
+
+  VectSU1->cleanOverlap(2);
+  VectSU2->cleanOverlap(2);
+
+  BOOST_CHECK_EQUAL(VectSU1->features().size(),FeaturesCount);
+  BOOST_CHECK_EQUAL(VectSU1->findOverlap().size(),0);
+  BOOST_CHECK_EQUAL(VectSU1->geometries()->toString(),VectSU2->geometries()->toString());
+
+  delete VectSU1;
+  delete VectSU2;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_DuplicateGeometry)
 {
   openfluid::core::GeoVectorValue ValueSU(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "SU.shp");
@@ -573,6 +997,35 @@ BOOST_AUTO_TEST_CASE(check_DuplicateGeometry)
 // =====================================================================
 
 
+BOOST_AUTO_TEST_CASE(check_DuplicateGeometry_buckets)
+{
+  openfluid::core::GeoVectorValue DuplicateSU(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "duplicateSU.shp");
+
+  openfluid::landr::VectorDataset* VectSU = new openfluid::landr::VectorDataset(DuplicateSU);
+
+  std::list<OGRFeature*> lDuplicate = VectSU->hasDuplicateGeometry();
+  BOOST_REQUIRE_EQUAL(lDuplicate.size(),2);
+
+  // duplicates are returned in layer order and are topologically equal
+  BOOST_CHECK(lDuplicate.front()->GetFID() < lDuplicate.back()->GetFID());
+  BOOST_CHECK(lDuplicate.front()->GetGeometryRef()->Equals(lDuplicate.back()->GetGeometryRef()));
+
+  delete VectSU;
+
+  openfluid::core::GeoVectorValue ValueRS(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "RS.shp");
+
+  openfluid::landr::VectorDataset* VectRS = new openfluid::landr::VectorDataset(ValueRS);
+
+  BOOST_CHECK_EQUAL(VectRS->hasDuplicateGeometry().size(),0);
+
+  delete VectRS;
+}
+
+
+// =====================================================================
+// =====================================================================
+
+
 BOOST_AUTO_TEST_CASE(check_parsing_Bad_Polygon_Geometry)
 {
   openfluid::core::GeoVectorValue ValueSU(CONFIGTESTS_DATA_INPUT_DIR + "/landr/", "BAD_POLYGEOM.shp");